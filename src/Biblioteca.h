@@ -15,29 +15,368 @@
 #include <stdlib.h>
 #include "stdbool.h"
 #include <string.h>
+#include <limits.h>
+#include <time.h>
 
 #define MAXCHAR 100
+#define MAXINDICE 16777216	//maior id guardado na tabela de ndice dos vrtices
+#define MINIMOINDICE 1024	//posies da tabela de ndice que podem ficar vazias sem limite
+#define FATORINDICE 8		//a tabela s cresce se tiver pelo menos um vrtice por este nmero de posies
+#define NIVEISINDICE 4		//nveis do mapa de ocupao da tabela de ndice (64^4 = MAXINDICE)
+#define TAMANHOBLOCOARENA 65536	//bytes de cada bloco da arena do grafo
+#define MAXVERTICESHELDKARP 28	//maior nmero de vrtices aceite pelo motor Held-Karp
+#define ORCAMENTOHELDKARP 268435456	//bytes da tabela Held-Karp por omisso; acima disso usa-se a poda
+#define TAREFASPORFIO 16		//tarefas geradas por fio na procura paralela
+#define MAXTAREFAS 65536		//limite de tarefas (prefixos de caminho) da procura paralela
+#define TAMANHOSAIDA 4194304	//bytes do buffer da sada de caminhos por omisso
+#define MINIMOORCAMENTO 65536	//menor oramento de memria aceite pela carga em streaming
+#define VERSAOGRAFOCSR 2		//verso do formato de ficheiro CSR
+#define VERSAOGRAFOCOMPACTO 2	//verso do formato de ficheiro compacto
+#define VERSAODIARIO 1			//verso do formato do dirio de alteraes
+#define VERSAOTABELACAMINHOS 1	//verso do formato de ficheiro da tabela de todos os pares
+#define LIMIARCARGAPARALELA 4194304	//a partir destes bytes, carregarMatrizParaGrafo usa vrios fios
+#define DENSIDADEMATRIZ 50		//percentagem mnima de clulas no nulas para guardar a matriz densa
+#define CAPACIDADECACHE 64		//consultas guardadas por omisso na cache de caminhos do grafo
 #pragma warning(disable: 4996)
 
 typedef struct Adjacencias {
 	int id;
 	int peso;
+	bool daArena;	//true se o n foi reservado na arena do grafo
 	struct Adjacencias* next;
 }Adjacencias;
 
 
 typedef struct Vertices {
 	int id;
+	bool daArena;	//true se o n foi reservado na arena do grafo
 	Adjacencias* proxAdj;
 	struct Vertices* proxVertice;
 }Vertices;
 
 
+typedef struct BlocoArena {
+	struct BlocoArena* proximo;	//os ns seguem-se a este cabealho
+}BlocoArena;
+
+
+typedef struct ArenaGrafo {
+	BlocoArena* blocos;			//lista de blocos reservados
+	char* livre;				//prxima posio livre no bloco atual
+	size_t restante;			//bytes ainda disponveis no bloco atual
+	Vertices* verticesLivres;	//vrtices eliminados prontos a reutilizar
+	Adjacencias* adjLivres;		//adjacncias eliminadas prontas a reutilizar
+}ArenaGrafo;
+
+
+typedef enum TipoRegistoDiario {
+	DIARIO_INSERE_VERTICE = 1,
+	DIARIO_INSERE_ADJ,
+	DIARIO_ELIMINA_ADJ,
+	DIARIO_ELIMINA_VERTICE
+}TipoRegistoDiario;
+
+
+/*
+ * Registo do dirio: uma alterao do grafo, com tamanho fixo para que um registo escrito
+ * a meio (por exemplo, numa falha) seja detetado e ignorado na reposio.
+ */
+typedef struct RegistoDiario {
+	int tipo;		//TipoRegistoDiario
+	int origem;		//vrtice inserido/eliminado, ou origem da adjacncia
+	int destino;
+	int peso;
+}RegistoDiario;
+
+
+typedef struct DiarioGrafo {
+	FILE* fp;				//aberto para acrescentar registos
+	char* nomeSnapshot;
+	char* nomeDiario;
+	long long numRegistos;	//registos desde a ltima compactao
+}DiarioGrafo;
+
+
+typedef struct EntradaAresta {
+	int origem;
+	int destino;
+	Adjacencias* adj;	//primeira adjacncia origem -> destino (NULL se a posio est livre)
+}EntradaAresta;
+
+
+/*
+ * Tabela de disperso (endereamento aberto, sondagem linear) das arestas do grafo.
+ */
+typedef struct TabelaArestas {
+	EntradaAresta* entradas;
+	size_t capacidade;	//potncia de 2
+	size_t ocupadas;
+}TabelaArestas;
+
+
+/*
+ * Representao densa das adjacncias: pesos numa matriz contgua, por linhas, e um mapa de
+ * bits com as clulas que so arestas. No admite arestas repetidas entre os mesmos vrtices.
+ */
+typedef struct MatrizDensa {
+	int numVertices;				//linhas e colunas (ids 0 a numVertices - 1)
+	int palavrasLinha;				//palavras de 64 bits por linha do mapa de presena
+	int* pesos;						//numVertices x numVertices
+	unsigned long long* presenca;	//bit j da linha i: existe a aresta i -> j
+}MatrizDensa;
+
+
 typedef struct Grafo {
 	Vertices* inicioGrafo;	//lista de vertices
+	Vertices** indiceVertices;	//tabela id -> vrtice para ids em [0, tamanhoIndice)
+	int tamanhoIndice;
+	int numIndexados;		//vrtices guardados na tabela de ndice
+	unsigned long long* ocupados[NIVEISINDICE];	//nvel 0: bit por posio ocupada; nvel k: bit por palavra no nula do nvel k-1
+	ArenaGrafo arena;		//ns de vrtices e adjacncias do grafo
+	DiarioGrafo* diario;	//dirio onde as alteraes so registadas (NULL se no houver)
+	Adjacencias** antecessores;	//arestas de entrada por id, com id = origem (NULL se inativo)
+	TabelaArestas* arestas;		//(origem, destino) -> adjacncia (NULL se inativa)
+	MatrizDensa* densa;			//adjacncias em matriz; as listas ficam vazias (NULL se usa listas)
+	unsigned long long versao;	//incrementada em cada alterao do grafo
+	struct CacheCaminhos* cache;	//resultados das procuras de caminhos (NULL se inativa)
 }Grafo;
 
 
+typedef struct ArestaGrafo {
+	int origem;
+	int destino;
+	int peso;
+}ArestaGrafo;
+
+
+typedef struct FicheiroMapeado {
+	const char* dados;		//contedo do ficheiro mapeado em memria (NULL se vazio)
+	size_t tamanho;
+	void* ficheiro;			//handles do sistema (Win32); no usados em POSIX
+	void* mapeamento;
+}FicheiroMapeado;
+
+
+/*
+ * Cabealho do ficheiro CSR. Seguem-se as seces de destinos, pesos, offsets e ids (int32),
+ * nas posies indicadas, todas alinhadas a 4 bytes. Os ids so os dos vrtices que existem,
+ * com ou sem arestas, por ordem crescente, e h um offset por cada um, pelo que o tamanho do
+ * ficheiro no depende do maior id. Os inteiros esto na ordem de bytes da mquina que
+ * escreveu o ficheiro, para que possa ser mapeado e usado sem converso.
+ */
+typedef struct CabecalhoGrafoCSR {
+	char magia[4];			//"GCSR"
+	int versao;
+	int numVertices;		//dimenso do espao de ids (maior id + 1)
+	int numArestas;
+	int numIds;				//nmero de vrtices que existem
+	int reservado;			//alinha as posies seguintes a 8 bytes
+	long long posInicioAdj;	//posio em bytes do vetor de offsets (numIds + 1)
+	long long posDestinos;	//posio em bytes do vetor de destinos (numArestas)
+	long long posPesos;		//posio em bytes do vetor de pesos (numArestas)
+	long long posIds;		//posio em bytes do vetor de ids (numIds)
+}CabecalhoGrafoCSR;
+
+
+typedef void (*ProgressoCarga)(long long bytesLidos, long long totalBytes, void* contexto);
+
+
+typedef struct QuadroDFS {
+	int vertice;			//vrtice do nvel atual do caminho
+	int soma;				//soma dos pesos do caminho at este vrtice
+	Adjacencias* cursor;	//prxima adjacncia a explorar
+	int coluna;				//prxima coluna a explorar, na representao densa
+}QuadroDFS;
+
+
+/*
+ * Recebe cada caminho encontrado: o array aponta para o buffer interno da procura (vlido s
+ * durante a chamada), com tamanho vrtices e a soma dos pesos das arestas. Devolve false para
+ * terminar a procura.
+ */
+typedef bool (*VisitanteCaminho)(const int* caminho, int tamanho, int peso, void* contexto);
+
+
+typedef struct SaidaCaminhos {
+	FILE* fp;					//ficheiro sem buffer do stdio; cada descarga  uma escrita
+	char* buffer;
+	size_t capacidade;
+	size_t usados;
+	bool binario;				//true: [tamanho][ids] em int32; false: texto como ProcuraProfundidade
+	long long bytesEscritos;
+	long long numCaminhos;
+	struct timespec inicio;		//instante de abertura, para o dbito
+}SaidaCaminhos;
+
+
+typedef struct GrafoCSR {
+	int numVertices;	//dimenso do espao de ids (maior id + 1)
+	int numArestas;
+	int* inicioAdj;		//offsets de cada vrtice, numVertices + 1 posies
+	int* destinos;		//ids de destino de todas as arestas, contguos
+	int* pesos;			//pesos alinhados com destinos
+	int numIds;			//nmero de vrtices que existem, com ou sem arestas
+	int* ids;			//ids dos vrtices que existem, por ordem crescente
+	FicheiroMapeado* ficheiro;	//mapeamento de onde vm os vetores (NULL se alocados)
+	bool offsetsAlocados;		//inicioAdj alocado  parte, mesmo com ficheiro (ids esparsos)
+}GrafoCSR;
+
+
+typedef enum MotorCaminho {
+	MOTOR_EXAUSTIVO,	//enumera todos os caminhos simples
+	MOTOR_PODA,			//branch-and-bound com limite superior do ganho restante
+	MOTOR_HELDKARP,		//programao dinmica sobre (subconjunto visitado, ltimo vrtice)
+	MOTOR_PARALELO,		//branch-and-bound repartido por vrios fios com roubo de tarefas
+	MOTOR_COMPONENTES,	//procura por componente fortemente conexa, combinada pela condensao
+	MOTOR_DAG,			//programao dinmica em ordem topolgica, para grafos sem ciclos
+	MOTOR_AUTOMATICO	//escolhido conforme a estrutura do grafo: DAG, componentes ou exaustivo
+}MotorCaminho;
+
+
+/*
+ * Resultado guardado de uma procura do caminho de maior soma. S  vlido enquanto a verso
+ * do grafo for a mesma de quando foi calculado.
+ */
+typedef struct EntradaCache {
+	int origem;
+	int destino;
+	MotorCaminho motor;
+	MotorCaminho motorUsado;		//algoritmo que calculou o resultado (difere de motor em MOTOR_AUTOMATICO)
+	unsigned long long versao;
+	int soma;
+	int tamanho;
+	int* caminho;					//tamanho vrtices
+	struct EntradaCache* anterior;	//entrada usada mais recentemente
+	struct EntradaCache* seguinte;	//entrada usada menos recentemente
+}EntradaCache;
+
+
+/*
+ * Cache de tamanho fixo das procuras de um grafo, com substituio da entrada usada h mais tempo.
+ */
+typedef struct CacheCaminhos {
+	EntradaCache* entradas;
+	int capacidade;
+	int ocupadas;
+	EntradaCache* maisRecente;
+	EntradaCache* menosRecente;
+	long long acertos;
+	long long falhas;
+}CacheCaminhos;
+
+
+/*
+ * Cabealho do ficheiro compacto. Seguem-se os offsets em bytes de cada vrtice no fluxo de
+ * destinos (int64, alinhados a 8), os offsets em arestas (int32), os ids dos vrtices que
+ * existem (int32, por ordem crescente), o fluxo de destinos (varint das diferenas) e o fluxo
+ * de pesos (bit-packed), nas posies indicadas. Tal como no CSR, h um offset por cada id.
+ */
+typedef struct CabecalhoGrafoCompacto {
+	char magia[4];			//"GCMP"
+	int versao;
+	int numVertices;
+	int numArestas;
+	int pesoMinimo;			//os pesos so guardados como peso - pesoMinimo
+	int bitsPeso;			//bits por peso (0 a 32)
+	int numIds;				//nmero de vrtices que existem
+	int reservado;			//alinha as posies seguintes a 8 bytes
+	long long posInicioBytes;	//numIds + 1 offsets
+	long long posInicioAdj;		//numIds + 1 offsets
+	long long posIds;
+	long long posAlvos;
+	long long tamanhoAlvos;
+	long long posPesos;
+	long long tamanhoPesos;	//inclui 8 bytes de folga no fim
+}CabecalhoGrafoCompacto;
+
+
+/*
+ * Grafo compacto s de leitura: os destinos de cada vrtice so diferenas em zigzag para o
+ * destino anterior (o primeiro em relao ao prprio vrtice), codificadas em varint; os
+ * pesos ocupam bitsPeso bits cada, pela ordem das arestas.
+ */
+typedef struct GrafoCompacto {
+	int numVertices;
+	int numArestas;
+	int* inicioAdj;				//ndice da primeira aresta de cada vrtice, numVertices + 1
+	long long* inicioBytes;		//posio no fluxo de destinos de cada vrtice, numVertices + 1
+	unsigned char* alvos;
+	unsigned char* pesos;
+	int pesoMinimo;
+	int bitsPeso;
+	int numIds;					//nmero de vrtices que existem, com ou sem arestas
+	int* ids;					//ids dos vrtices que existem, por ordem crescente
+	FicheiroMapeado* ficheiro;	//mapeamento de onde vm os vetores (NULL se alocados)
+	bool offsetsAlocados;		//inicioAdj e inicioBytes alocados  parte, mesmo com ficheiro
+}GrafoCompacto;
+
+
+typedef struct CursorVizinhos {
+	const unsigned char* p;		//prximo byte do fluxo de destinos
+	int restantes;
+	int anterior;				//ltimo destino descodificado
+	const unsigned char* pesos;
+	long long bit;				//posio em bits do prximo peso
+	int bitsPeso;
+	int pesoMinimo;
+}CursorVizinhos;
+
+
+/*
+ * Cabealho do ficheiro da tabela de todos os pares. Seguem-se os offsets dos caminhos (int64,
+ * numVertices^2 + 1, alinhados a 8), as somas (int32, numVertices^2) e os vrtices de todos os
+ * caminhos (int32), nas posies indicadas. O par (origem, destino) ocupa a posio
+ * origem * numVertices + destino das duas primeiras seces.
+ */
+typedef struct CabecalhoTabelaCaminhos {
+	char magia[4];				//"GTAB"
+	int versao;
+	int numVertices;
+	int reservado;
+	long long posInicioCaminhos;
+	long long posSomas;
+	long long posCaminhos;
+	long long tamanhoCaminhos;	//nmero total de vrtices dos caminhos
+}CabecalhoTabelaCaminhos;
+
+
+/*
+ * Caminhos de maior soma entre todos os pares de vrtices: a soma e o caminho de cada par
+ * (vazio, com soma 0, se no houver caminho de soma positiva).
+ */
+typedef struct TabelaCaminhos {
+	int numVertices;
+	int* somas;					//numVertices x numVertices, por origem
+	long long* inicioCaminhos;	//incio do caminho de cada par em caminhos, numVertices^2 + 1
+	int* caminhos;
+	FicheiroMapeado* ficheiro;	//mapeamento de onde vm os vetores (NULL se alocados)
+}TabelaCaminhos;
+
+
+typedef struct TabelaHeldKarp {
+	int numVertices;	//vrtices da tabela (s os que podem estar num caminho)
+	int origem;			//posio da origem na tabela
+	int* vertices;		//id de cada vrtice da tabela
+	int* posicao;		//posio na tabela de cada id do snapshot, -1 se excludo
+	int* somas;			//(2^(numVertices-1)) x numVertices estados; INT_MIN se inatingvel
+	int* melhor;		//melhor soma de um caminho de origem at cada vrtice
+	int* mascaraMelhor;	//subconjunto visitado pelo melhor caminho de cada vrtice
+}TabelaHeldKarp;
+
+
+/*
+ * Componentes fortemente conexas de um grafo, numeradas pela ordem topolgica inversa da
+ * condensao: uma aresta entre componentes diferentes vai sempre para um ndice menor.
+ */
+typedef struct ComponentesFortes {
+	int numVertices;
+	int numComponentes;
+	int* componente;		//componente de cada vrtice (-1 se excludo), numVertices posies
+	int* inicioMembros;		//incio dos vrtices de cada componente em membros, numComponentes + 1
+	int* membros;			//vrtices agrupados por componente
+}ComponentesFortes;
+
+
 
 #pragma region Vertices 
 
@@ -63,22 +402,152 @@ Adjacencias* EliminaTodasAdjacencias(Adjacencias* listAdj, bool* res);
 
 #pragma endregion 
 
+#pragma region Arena
+
+void* ReservaArena(ArenaGrafo* arena, size_t tamanho);
+Vertices* CriaVerticeArena(Grafo* g, int id);
+Adjacencias* NovaAdjacenciaArena(Grafo* g, int id, int peso);
+void LibertaVerticeArena(Grafo* g, Vertices* v);
+void LibertaAdjacenciaArena(Grafo* g, Adjacencias* adj);
+Adjacencias* EliminaAdjArena(Grafo* g, Adjacencias* listaAdjacencias, int codAdj, bool* res);
+void DestroiArena(ArenaGrafo* arena);
+
+#pragma endregion
+
 #pragma region Grafo
 Grafo* CriaGrafo();
+void DestroiGrafo(Grafo* g);
 bool ExisteVerticeGrafo(Grafo* g, int idVertice);
 Grafo* InsereVerticeGrafo(Grafo* g, Vertices* novo, int* res);
 Vertices* OndeEstaVerticeGrafo(Grafo* g, int idVertice);
 Grafo* EliminaVerticeGrafo(Grafo* g, int codVertice, bool* res);
 Grafo* EliminaAdjGrafo(Grafo* g, int origem, int destino, bool* res);
 Grafo* InsereAdjacenciasGrafo(Grafo* g, int idOrigem, int idDestino, int peso, bool* res);
+Grafo* InsereArestasGrafo(Grafo* g, const ArestaGrafo* arestas, int numArestas, bool criaVertices, int* numInseridas);
 void MostrarGrafo(Vertices* grafo);
+void ImprimeGrafo(Grafo* g);
+bool RegistaVerticeIndice(Grafo* g, Vertices* v);
+bool ReservaIndiceVertices(Grafo* g, int idMaximo);
+void RemoveVerticeIndice(Grafo* g, int idVertice);
+bool AtivaAntecessores(Grafo* g);
+void DesativaAntecessores(Grafo* g);
+Adjacencias* AntecessoresGrafo(Grafo* g, int idVertice);
+bool AtivaTabelaArestas(Grafo* g);
+void DesativaTabelaArestas(Grafo* g);
+bool PesoAresta(Grafo* g, int origem, int destino, int* peso);
+bool ConverteGrafoDenso(Grafo* g);
+bool ConverteGrafoListas(Grafo* g);
 
 #pragma endregion
 
 Grafo* carregarMatrizParaGrafo(char fileName[], int* numLinhas, int* numColunas);
+bool MapeiaFicheiro(char fileName[], FicheiroMapeado* mapa);
+void DesmapeiaFicheiro(FicheiroMapeado* mapa);
+Grafo* ConstroiGrafoMatriz(const char* dados, size_t tamanho, int* numLinhas, int* numColunas);
+Grafo* ConstroiGrafoMatrizParalelo(const char* dados, size_t tamanho, int* numLinhas, int* numColunas, int numFios);
+Grafo* carregarMatrizParaGrafoParalelo(char fileName[], int* numLinhas, int* numColunas, int numFios);
+bool ConverteMatrizParaCSR(char ficheiroMatriz[], char ficheiroCSR[], size_t orcamento, ProgressoCarga progresso, void* contexto, int* numLinhas, int* numColunas);
 bool GuardaGrafoBinario(Grafo* grafo, char fileName[]);
-int CarregaGrafoBinario(char fileName[]);
+Grafo* CarregaGrafoBinario(char fileName[]);
 Grafo* ProcuraProfundidadeRec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos);
 Grafo* ProcuraProfundidade(Grafo* g, int origem, int destino, int numVertices, int* soma);
 Grafo* DFSrec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos, int* somaMaxima, int* caminhoMaximo, int numVertices);
 void encontrarCaminhoMaiorSoma(Grafo* g, int origem, int destino, int numVertices);
+Grafo* ProcuraProfundidadeIter(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, int* somaCaminhos, int numVertices);
+Grafo* ProcuraProfundidadeVisita(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, VisitanteCaminho visitante, void* contexto, int numVertices);
+Grafo* PercorreCaminhos(Grafo* g, int origem, int destino, int numVertices, VisitanteCaminho visitante, void* contexto);
+bool VisitanteMostraCaminho(const int* caminho, int tamanho, int peso, void* contexto);
+Grafo* DFSiter(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, int* somaMaxima, int* caminhoMaximo, int numVertices);
+bool MarcaInalcancaveis(Grafo* g, int origem, int destino, bool* visitado, int numVertices);
+
+#pragma region Cache
+
+bool AtivaCacheCaminhos(Grafo* g, int capacidade);
+void DesativaCacheCaminhos(Grafo* g);
+bool ConsultaCacheCaminhos(Grafo* g, int origem, int destino, MotorCaminho motor, int* caminho, int* tamanho, int* soma);
+void GuardaCacheCaminhos(Grafo* g, int origem, int destino, MotorCaminho motor, const int* caminho, int tamanho, int soma);
+void EstatisticasCacheCaminhos(Grafo* g, long long* acertos, long long* falhas);
+
+#pragma endregion
+
+#pragma region CSR
+
+GrafoCSR* CongelaGrafo(Grafo* g);
+void DestroiGrafoCSR(GrafoCSR* csr);
+Grafo* DescongelaGrafo(GrafoCSR* csr);
+bool GuardaGrafoCSR(GrafoCSR* csr, char fileName[]);
+GrafoCSR* MapeiaGrafoCSR(char fileName[]);
+GrafoCSR* ProcuraProfundidadeCSRRec(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos);
+GrafoCSR* ProcuraProfundidadeCSR(GrafoCSR* csr, int origem, int destino, int* soma);
+GrafoCSR* PercorreCaminhosCSR(GrafoCSR* csr, int origem, int destino, VisitanteCaminho visitante, void* contexto);
+GrafoCSR* DFSrecCSR(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int somaAtual, int* somaMaxima, int* caminhoMaximo, int* tamanhoMaximo);
+GrafoCSR* DFSPodaCSR(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int somaAtual, long long livre, int* maxSaida, int* somaMaxima, int* caminhoMaximo, int* tamanhoMaximo);
+size_t MemoriaHeldKarp(int numVertices);
+TabelaHeldKarp* HeldKarpCSR(GrafoCSR* csr, int origem, const bool* ativo, size_t orcamento);
+int CaminhoHeldKarp(TabelaHeldKarp* tabela, GrafoCSR* csr, int destino, int* caminho, int* tamanho);
+void DestroiTabelaHeldKarp(TabelaHeldKarp* tabela);
+int CaminhoMaiorSomaCSR(GrafoCSR* csr, int origem, int destino, MotorCaminho motor, int* caminhoMaximo, int* tamanhoMaximo);
+void encontrarCaminhoMaiorSomaCSR(GrafoCSR* csr, int origem, int destino, MotorCaminho motor);
+void encontrarCaminhoMaiorSomaModo(Grafo* g, int origem, int destino, MotorCaminho motor);
+
+#pragma endregion
+
+#pragma region Paralelo
+
+GrafoCSR* ProcuraProfundidadeParaleloCSR(GrafoCSR* csr, int origem, int destino, int numFios, long long* soma, long long* numCaminhos);
+int CaminhoMaiorSomaParaleloCSR(GrafoCSR* csr, int origem, int destino, int numFios, int* caminhoMaximo, int* tamanhoMaximo);
+TabelaCaminhos* TodosParesMaiorSomaCSR(GrafoCSR* csr, int numFios);
+TabelaCaminhos* TodosParesMaiorSoma(Grafo* g, int numFios);
+int CaminhoTabela(TabelaCaminhos* tabela, int origem, int destino, const int** caminho, int* tamanho);
+bool GuardaTabelaCaminhos(TabelaCaminhos* tabela, char fileName[]);
+TabelaCaminhos* MapeiaTabelaCaminhos(char fileName[]);
+void DestroiTabelaCaminhos(TabelaCaminhos* tabela);
+
+#pragma endregion
+
+#pragma region Componentes
+
+ComponentesFortes* ComponentesFortesCSR(GrafoCSR* csr);
+ComponentesFortes* ComponentesFortesGrafo(Grafo* g);
+ComponentesFortes* ComponentesCaminhoCSR(GrafoCSR* csr, int origem, int destino);
+void DestroiComponentesFortes(ComponentesFortes* componentes);
+int CaminhoMaiorSomaComponentesCSR(GrafoCSR* csr, int origem, int destino, int numFios, int* caminhoMaximo, int* tamanhoMaximo);
+bool GrafoAciclicoCSR(GrafoCSR* csr);
+bool GrafoAciclico(Grafo* g);
+int CaminhoMaiorSomaDAGCSR(GrafoCSR* csr, int origem, int destino, int* caminhoMaximo, int* tamanhoMaximo);
+
+#pragma endregion
+
+#pragma region Compacto
+
+GrafoCompacto* ComprimeGrafoCSR(GrafoCSR* csr);
+GrafoCSR* DescomprimeGrafo(GrafoCompacto* gc);
+void DestroiGrafoCompacto(GrafoCompacto* gc);
+bool GuardaGrafoCompacto(GrafoCompacto* gc, char fileName[]);
+GrafoCompacto* MapeiaGrafoCompacto(char fileName[]);
+bool GuardaGrafoBinarioCompacto(Grafo* grafo, char fileName[]);
+void IniciaVizinhos(GrafoCompacto* gc, int vertice, CursorVizinhos* cursor);
+bool ProximoVizinho(CursorVizinhos* cursor, int* destino, int* peso);
+GrafoCompacto* PercorreCaminhosCompacto(GrafoCompacto* gc, int origem, int destino, VisitanteCaminho visitante, void* contexto);
+
+#pragma endregion
+
+#pragma region Diario
+
+Grafo* AbreGrafoComDiario(char ficheiroSnapshot[], char ficheiroDiario[]);
+bool RegistaDiario(Grafo* g, TipoRegistoDiario tipo, int origem, int destino, int peso);
+bool CompactaDiario(Grafo* g);
+void FechaDiario(Grafo* g);
+
+#pragma endregion
+
+#pragma region Saida
+
+SaidaCaminhos* AbreSaidaCaminhos(char fileName[], bool binario, size_t capacidade);
+bool EscreveCaminho(SaidaCaminhos* saida, const int* caminho, int tamanho);
+bool DescarregaSaidaCaminhos(SaidaCaminhos* saida);
+double DebitoSaidaCaminhos(SaidaCaminhos* saida);
+bool FechaSaidaCaminhos(SaidaCaminhos* saida);
+bool VisitanteSaidaCaminhos(const int* caminho, int tamanho, int peso, void* contexto);
+
+#pragma endregion
@@ -8,8 +8,246 @@
     @copyright Joo Barbosa, 2024. All right reserved.
 
 **/
+// madvise, MADV_*, fseeko e ftello no fazem parte do C11 estrito (-std=c11); tm de ser pedidos antes de qualquer #include
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+
 #include "Biblioteca.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USA_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#pragma region Fios
+
+/*
+ * Camada mnima sobre os fios de execuo do sistema (Win32 ou pthreads),
+ * usada pelas operaes paralelas da biblioteca.
+ */
+#ifdef _WIN32
+typedef CRITICAL_SECTION Trinco;
+#define IniciaTrinco(t) InitializeCriticalSection(t)
+#define FechaTrinco(t) EnterCriticalSection(t)
+#define AbreTrinco(t) LeaveCriticalSection(t)
+#define DestroiTrinco(t) DeleteCriticalSection(t)
+#else
+typedef pthread_mutex_t Trinco;
+#define IniciaTrinco(t) pthread_mutex_init(t, NULL)
+#define FechaTrinco(t) pthread_mutex_lock(t)
+#define AbreTrinco(t) pthread_mutex_unlock(t)
+#define DestroiTrinco(t) pthread_mutex_destroy(t)
+#endif
+
+typedef void (*TarefaFio)(void* contexto);
+
+typedef struct ArranqueFio {
+	TarefaFio funcao;
+	void* contexto;
+}ArranqueFio;
+
+
+/**
+ * @brief Devolve o nmero de processadores disponveis.
+ *
+ * @return O nmero de processadores, no mnimo 1.
+ */
+static int NumeroProcessadores(void) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0) ? (int)info.dwNumberOfProcessors : 1;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (int)n : 1;
+#endif
+}
+
+
+/**
+ * @brief L um inteiro partilhado entre fios.
+ */
+static int LeAtomico(volatile int* valor) {
+#ifdef _WIN32
+	return InterlockedCompareExchange((volatile LONG*)valor, 0, 0);
+#else
+	return __atomic_load_n(valor, __ATOMIC_ACQUIRE);
+#endif
+}
+
+
+/**
+ * @brief Atualiza um inteiro partilhado para o mximo entre o valor atual e o candidato.
+ */
+static void MaximoAtomico(volatile int* valor, int candidato) {
+	int atual = LeAtomico(valor);
+	while (candidato > atual) {
+#ifdef _WIN32
+		int visto = InterlockedCompareExchange((volatile LONG*)valor, candidato, atual);
+		if (visto == atual) return;
+		atual = visto;
+#else
+		if (__atomic_compare_exchange_n(valor, &atual, candidato, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return;
+#endif
+	}
+}
+
+/**
+ * @brief Incrementa um inteiro partilhado entre fios.
+ *
+ * @return O valor anterior ao incremento.
+ */
+static int IncrementaAtomico(volatile int* valor) {
+#ifdef _WIN32
+	return InterlockedExchangeAdd((volatile LONG*)valor, 1);
+#else
+	return __atomic_fetch_add(valor, 1, __ATOMIC_ACQ_REL);
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI ArrancaFio(LPVOID p) {
+	ArranqueFio* arranque = (ArranqueFio*)p;
+	arranque->funcao(arranque->contexto);
+	return 0;
+}
+#else
+static void* ArrancaFio(void* p) {
+	ArranqueFio* arranque = (ArranqueFio*)p;
+	arranque->funcao(arranque->contexto);
+	return NULL;
+}
+#endif
+
+
+/**
+ * @brief Executa uma funo em vrios fios e espera que todos terminem.
+ *
+ * O fio i recebe o contexto que comea em contextos + i * tamanhoContexto. O fio 0
+ *  o prprio chamador. Se no for possvel criar um fio, o seu trabalho  feito
+ * pelo chamador no fim, pelo que o resultado  sempre completo.
+ *
+ * @param numFios Nmero de fios a utilizar.
+ * @param funcao Funo executada por cada fio.
+ * @param contextos Array de contextos, um por fio.
+ * @param tamanhoContexto Tamanho em bytes de cada contexto.
+ */
+static void ExecutaEmParalelo(int numFios, TarefaFio funcao, void* contextos, size_t tamanhoContexto) {
+	if (numFios <= 1) {
+		funcao(contextos);
+		return;
+	}
+
+	ArranqueFio* arranques = (ArranqueFio*)malloc(numFios * sizeof(ArranqueFio));
+	bool* lancado = (bool*)calloc(numFios, sizeof(bool));
+#ifdef _WIN32
+	HANDLE* fios = (HANDLE*)malloc(numFios * sizeof(HANDLE));
+#else
+	pthread_t* fios = (pthread_t*)malloc(numFios * sizeof(pthread_t));
+#endif
+	if (arranques == NULL || lancado == NULL || fios == NULL) {
+		free(arranques);
+		free(lancado);
+		free(fios);
+		for (int i = 0; i < numFios; i++) {
+			funcao((char*)contextos + i * tamanhoContexto);
+		}
+		return;
+	}
+
+	for (int i = 1; i < numFios; i++) {
+		arranques[i].funcao = funcao;
+		arranques[i].contexto = (char*)contextos + i * tamanhoContexto;
+#ifdef _WIN32
+		fios[i] = CreateThread(NULL, 0, ArrancaFio, &arranques[i], 0, NULL);
+		lancado[i] = (fios[i] != NULL);
+#else
+		lancado[i] = (pthread_create(&fios[i], NULL, ArrancaFio, &arranques[i]) == 0);
+#endif
+	}
+
+	funcao(contextos);
+
+	for (int i = 1; i < numFios; i++) {
+		if (lancado[i]) {
+#ifdef _WIN32
+			WaitForSingleObject(fios[i], INFINITE);
+			CloseHandle(fios[i]);
+#else
+			pthread_join(fios[i], NULL);
+#endif
+		}
+		else {
+			funcao((char*)contextos + i * tamanhoContexto);
+		}
+	}
+
+	free(arranques);
+	free(lancado);
+	free(fios);
+}
+
+#pragma endregion
+
+/**
+ * @brief Devolve o ndice do bit a 1 menos significativo (mscara diferente de zero).
+ */
+static int BitMenosSignificativo(unsigned long long mascara) {
+#ifdef _MSC_VER
+	unsigned long indice;
+	_BitScanForward64(&indice, mascara);
+	return (int)indice;
+#else
+	return __builtin_ctzll(mascara);
+#endif
+}
+
+
+/**
+ * @brief Devolve o ndice do bit a 1 mais significativo (mscara diferente de zero).
+ */
+static int BitMaisSignificativo(unsigned long long mascara) {
+#ifdef _MSC_VER
+	unsigned long indice;
+	_BitScanReverse64(&indice, mascara);
+	return (int)indice;
+#else
+	return 63 - __builtin_clzll(mascara);
+#endif
+}
+
+
+/**
+ * @brief Conta os bits a 1 de uma mscara.
+ *
+ * @param mascara A mscara a contar.
+ * @return O nmero de bits a 1.
+ */
+static int ContaBits(unsigned long long mascara) {
+	int n = 0;
+	while (mascara != 0) {
+		mascara &= mascara - 1;
+		n++;
+	}
+	return n;
+}
+
+
 #pragma region Vertices 
 /**
  * @brief Cria um novo vrtice com o identificador especificado.
@@ -26,6 +264,7 @@ Vertices* CriaVertice(int id) {
 		return NULL;
 	}
 	aux->id = id;
+	aux->daArena = false;
 
 	aux->proxVertice = NULL;
 	aux->proxAdj = NULL;
@@ -128,11 +367,12 @@ Vertices* OndeEstaVertice(Vertices* inicio, int id) {
  * @brief Liberta a memria alocada para a estrutura de adjacncias.
  *
  * Esta funo libera a memria alocada para a estrutura de adjacncias.
+ * As adjacncias reservadas na arena do grafo no so libertadas; pertencem ao grafo.
  *
  * @param destroir Um apontador para a estrutura de adjacncias a ser liberada.
  */
 void destroiAdjacencias(Adjacencias* destroir) {
-	free(destroir);
+	if (destroir != NULL && !destroir->daArena) free(destroir);
 }
 
 
@@ -154,7 +394,7 @@ Adjacencias* EliminaAllAdj(Adjacencias* listaAdjacencias, bool* res) {
 	Adjacencias* prox;
 	while (aux != NULL) {
 		prox = aux->next;
-		free(aux);
+		destroiAdjacencias(aux);
 		aux = prox;
 	}
 	*res = true;
@@ -194,7 +434,7 @@ Adjacencias* EliminaAdj(Adjacencias* listaAdjacencias, int codAdj, bool* res) {
 		// A adjacncia a ser removida no  a primeira da lista
 		ant->next = aux->next;
 	}
-	free(aux);
+	destroiAdjacencias(aux);
 	*res = true;
 	return listaAdjacencias;
 }
@@ -287,6 +527,7 @@ Adjacencias* NovaAdjacencia(int id, int peso) {
 	}
 	adjacente->id = id;
 	adjacente->peso = peso;
+	adjacente->daArena = false;
 	adjacente->next = NULL;
 	return adjacente;
 }
@@ -331,7 +572,7 @@ Adjacencias* InsereAdj(Adjacencias* listaAdja, int idDestino, int peso) {
  * @param ptAdjacent Um apontador para a adjacncia a ser destruda.
  */
 void DestroiAdjacencia(Adjacencias* ptAdjacent) {
-	free(ptAdjacent);
+	destroiAdjacencias(ptAdjacent);
 }
 
 
@@ -363,617 +604,7194 @@ Adjacencias* EliminaTodasAdjacencias(Adjacencias* listAdj, bool* res) {
 
 #pragma endregion
 
-#pragma region Grafo
+#pragma region Arena
 
 /**
- * @brief Cria um novo grafo.
+ * @brief Reserva um bloco de memria na arena de um grafo.
  *
- * Esta funo aloca dinamicamente memria para um novo grafo e inicializa seus campos.
+ * A memria  retirada do bloco atual da arena; quando este se esgota  reservado um novo
+ * bloco de TAMANHOBLOCOARENA bytes. A memria da arena s  libertada de uma vez, com DestroiArena.
  *
- * @return Um apontador para o novo grafo criado, ou NULL se a alocao de memria falhar.
+ * @param arena Apontador para a arena.
+ * @param tamanho Nmero de bytes a reservar.
+ * @return Um apontador para a memria reservada, ou NULL se a alocao falhar.
  */
-Grafo* CriaGrafo() {
-	Grafo* novoGrafo = (Grafo*)malloc(sizeof(Grafo));
-	if (novoGrafo == NULL) {
-		return NULL;
-	}
+void* ReservaArena(ArenaGrafo* arena, size_t tamanho) {
+	if (arena == NULL || tamanho == 0 || tamanho > TAMANHOBLOCOARENA) return NULL;
 
-	novoGrafo->inicioGrafo = NULL;
+	// Mantm todos os ns alinhados a 8 bytes
+	tamanho = (tamanho + 7) & ~(size_t)7;
 
-	return novoGrafo;
-}
+	if (tamanho > arena->restante) {
+		BlocoArena* bloco = (BlocoArena*)malloc(sizeof(BlocoArena) + TAMANHOBLOCOARENA);
+		if (bloco == NULL) return NULL;
+		bloco->proximo = arena->blocos;
+		arena->blocos = bloco;
+		arena->livre = (char*)(bloco + 1);
+		arena->restante = TAMANHOBLOCOARENA;
+	}
 
-/**
- * @brief Verifica se um vrtice com o identificador especifico existe no grafo.
- *
- * Esta funo verifica se um vrtice com o identificador especifico existe no grafo.
- *
- * @param g Um apontador para o grafo.
- * @param idVertice O identificador do vrtice a ser verificado.
- * @return true se um vrtice com o identificador especificado existir no grafo, false caso contrrio.
- */
-bool ExisteVerticeGrafo(Grafo* g, int idVertice) {
-	if (g == NULL) return false;
-	return (ExisteVertice(g->inicioGrafo, idVertice));
+	void* mem = arena->livre;
+	arena->livre += tamanho;
+	arena->restante -= tamanho;
+	return mem;
 }
 
 
 /**
- * @brief Insere um novo vrtice no grafo.
+ * @brief Cria um novo vrtice na arena do grafo.
  *
- * Esta funo insere um novo vrtice no grafo, realizando algumas validaes.
+ * Reutiliza um vrtice eliminado anteriormente, se existir, ou reserva um novo na arena.
+ * O vrtice criado pertence ao grafo e  libertado por DestroiGrafo.
  *
  * @param g Um apontador para o grafo.
- * @param novo Um apontador para o vrtice a ser inserido.
- * @param res Um ponteiro para uma varivel inteira que indica o resultado da operao:
- *            1 - insero bem-sucedida,
- *            0 - vrtice invlido,
- *           -1 - grafo vazio,
- *           -2 - vrtice j existente no grafo.
- * @return Um apontador para o grafo aps a insero do vrtice.
+ * @param id O identificador do vrtice a ser criado.
+ * @return Um apontador para o vrtice criado, ou NULL se a alocao falhar.
  */
-Grafo* InsereVerticeGrafo(Grafo* g, Vertices* novo, int* res) {
-	*res = 1;
-	if (novo == NULL) { //vertice invalido
-		*res = 0;
-		return g;
-	}
-	if (g == NULL) { // grafo vazio
-		*res = -1;
-		return NULL;
+Vertices* CriaVerticeArena(Grafo* g, int id) {
+	if (g == NULL) return NULL;
+
+	Vertices* aux = g->arena.verticesLivres;
+	if (aux != NULL) {
+		g->arena.verticesLivres = aux->proxVertice;
 	}
-	//verificar se V j existe no grafo...
-	if (ExisteVerticeGrafo(g, novo->id)) { //vertice desconhecido
-		*res = -2;
-		return g;
+	else {
+		aux = (Vertices*)ReservaArena(&g->arena, sizeof(Vertices));
+		if (aux == NULL) return NULL;
 	}
-
-	g->inicioGrafo = InsereVertice(g->inicioGrafo, novo, res);
-
-	return g;
+	aux->id = id;
+	aux->daArena = true;
+	aux->proxVertice = NULL;
+	aux->proxAdj = NULL;
+	return aux;
 }
 
 
 /**
- * @brief Encontra um vrtice com o identificador especificado no grafo.
+ * @brief Cria uma nova adjacncia na arena do grafo.
  *
- * Esta funo verifica se um vrtice com o identificador especificado existe no grafo e retorna um apontador para ele.
+ * Reutiliza uma adjacncia eliminada anteriormente, se existir, ou reserva uma nova na arena.
  *
  * @param g Um apontador para o grafo.
- * @param idVertice O identificador do vrtice a ser encontrado.
- * @return Um apontador para o vrtice com o identificador especificado, ou NULL se no for encontrado.
+ * @param id O identificador do vrtice de destino da adjacncia.
+ * @param peso O peso da adjacncia.
+ * @return Um apontador para a nova adjacncia, ou NULL se a alocao falhar.
  */
-Vertices* OndeEstaVerticeGrafo(Grafo* g, int idVertice) {
+Adjacencias* NovaAdjacenciaArena(Grafo* g, int id, int peso) {
 	if (g == NULL) return NULL;
-	return (OndeEstaVertice(g->inicioGrafo, idVertice));
+
+	Adjacencias* adjacente = g->arena.adjLivres;
+	if (adjacente != NULL) {
+		g->arena.adjLivres = adjacente->next;
+	}
+	else {
+		adjacente = (Adjacencias*)ReservaArena(&g->arena, sizeof(Adjacencias));
+		if (adjacente == NULL) return NULL;
+	}
+	adjacente->id = id;
+	adjacente->peso = peso;
+	adjacente->daArena = true;
+	adjacente->next = NULL;
+	return adjacente;
 }
 
 
 /**
- * @brief Remove um vrtice com o cdigo especificado do grafo, juntamente com todas as suas adjacncias.
+ * @brief Devolve um vrtice ao grafo para ser reutilizado.
  *
- * Esta funo remove um vrtice com o cdigo especificado do grafo, juntamente com todas as suas adjacncias.
+ * Os vrtices da arena passam para a lista de livres; os vrtices criados com CriaVertice so libertados.
  *
  * @param g Um apontador para o grafo.
- * @param codVertice O cdigo do vrtice a ser removido.
- * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
- * @return Um apontador para o grafo aps a remoo do vrtice e suas adjacncias.
+ * @param v Um apontador para o vrtice a libertar.
  */
-Grafo* EliminaVerticeGrafo(Grafo* g, int codVertice, bool* res) {
-	*res = false;
-	if (g == NULL) return NULL;
-
-	g->inicioGrafo = EliminaVertice(g->inicioGrafo, codVertice, res);
-	g->inicioGrafo = EliminaAdjacenciaVertices(g->inicioGrafo, codVertice, res);
-
-	return g;
+void LibertaVerticeArena(Grafo* g, Vertices* v) {
+	if (g == NULL || v == NULL) return;
+	if (!v->daArena) {
+		free(v);
+		return;
+	}
+	v->proxAdj = NULL;
+	v->proxVertice = g->arena.verticesLivres;
+	g->arena.verticesLivres = v;
 }
 
 
 /**
- * @brief Remove uma adjacncia entre dois vrtices do grafo.
+ * @brief Devolve uma adjacncia  lista de livres da arena do grafo.
  *
- * Esta funo remove uma adjacncia entre dois vrtices do grafo, se eles existirem.
+ * As adjacncias da arena passam para a lista de livres; as criadas com NovaAdjacencia so libertadas.
  *
  * @param g Um apontador para o grafo.
- * @param origem O identificador do vrtice de origem da adjacncia.
- * @param destino O identificador do vrtice de destino da adjacncia.
- * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
- * @return Um apontador para o grafo aps a remoo da adjacncia entre os vrtices.
+ * @param adj Um apontador para a adjacncia a libertar.
  */
-Grafo* EliminaAdjGrafo(Grafo* g, int origem, int destino, bool* res) {
-
-	*res = false;
-
-	//validaes
-	if (g == NULL) return NULL;
-	//Verificar se vertices existem
-	Vertices* origemV = OndeEstaVerticeGrafo(g, origem);
-	if (origemV == NULL) return g;
-	Vertices* destinoV = OndeEstaVerticeGrafo(g, destino);
-	if (!destinoV) return g;
-
-	origemV->proxAdj = EliminaAdj(origemV->proxAdj, destino, res);
-	return g;
+void LibertaAdjacenciaArena(Grafo* g, Adjacencias* adj) {
+	if (g == NULL || adj == NULL) return;
+	if (!adj->daArena) {
+		free(adj);
+		return;
+	}
+	adj->next = g->arena.adjLivres;
+	g->arena.adjLivres = adj;
 }
 
 
-
 /**
- * @brief Insere uma nova adjacncia entre dois vrtices no grafo.
+ * @brief Remove uma adjacncia de uma lista do grafo, devolvendo o n  arena.
  *
- * Esta funo insere uma nova adjacncia entre dois vrtices no grafo, se eles existirem.
+ * Equivalente a EliminaAdj para listas cujos ns pertencem  arena do grafo.
  *
  * @param g Um apontador para o grafo.
- * @param idOrigem O identificador do vrtice de origem da adjacncia.
- * @param idDestino O identificador do vrtice de destino da adjacncia.
- * @param peso O peso da adjacncia.
+ * @param listaAdjacencias Um apontador para o incio da lista de adjacncias.
+ * @param codAdj O cdigo da adjacncia a ser removida.
  * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
- * @return Um apontador para o grafo aps a insero da adjacncia entre os vrtices.
+ * @return Um apontador para o incio da lista de adjacncias aps a remoo.
  */
-Grafo* InsereAdjacenciasGrafo(Grafo* g, int idOrigem, int idDestino, int peso, bool* res) {
-	if (res == NULL) {
-		return g;
-	}
+Adjacencias* EliminaAdjArena(Grafo* g, Adjacencias* listaAdjacencias, int codAdj, bool* res) {
 	*res = false;
+	if (listaAdjacencias == NULL) return NULL;
 
-	if (g == NULL) {
-		return g;
+	Adjacencias* ant = NULL;
+	Adjacencias* aux = listaAdjacencias;
+	while (aux && aux->id != codAdj) {
+		ant = aux;
+		aux = aux->next;
 	}
+	if (aux == NULL) return listaAdjacencias; // Adjacncia no encontrada
 
-	// Verificar se os vrtices de origem e destino existem no grafo
-	Vertices* origemV = OndeEstaVerticeGrafo(g, idOrigem);
-	Vertices* destinoV = OndeEstaVerticeGrafo(g, idDestino);
-	if (origemV == NULL || destinoV == NULL) {
-		return g;
+	if (ant == NULL) {
+		listaAdjacencias = aux->next;
 	}
-
-	// Inserir a nova adjacncia na lista de adjacncias do vrtice de origem
-	origemV->proxAdj = InsereAdj(origemV->proxAdj, idDestino, peso);
-	if (origemV->proxAdj == NULL) {
-		return g;
+	else {
+		ant->next = aux->next;
 	}
-
+	LibertaAdjacenciaArena(g, aux);
 	*res = true;
-	return g;
+	return listaAdjacencias;
 }
 
 
 /**
- * @brief Mostra na sada padro a representao do grafo.
- *
- * Esta funo mostra na sada padro a representao do grafo, exibindo os vrtices
- * e suas adjacncias, juntamente com os pesos das adjacncias.
+ * @brief Liberta de uma s vez todos os blocos de uma arena.
  *
- * @param grafo Um apontador para o primeiro vrtice do grafo.
+ * @param arena Apontador para a arena a libertar.
  */
-void MostrarGrafo(Vertices* grafo) {
-	Vertices* atual = grafo;
-	while (atual != NULL) {
-		printf("vertice:%d \n", atual->id);
-		Adjacencias* AdjacenciaAtual = atual->proxAdj;
-		while (AdjacenciaAtual != NULL)
-		{
-			printf("\tadjacente com:%d com peso de:%d \n", AdjacenciaAtual->id, AdjacenciaAtual->peso);
-			AdjacenciaAtual = AdjacenciaAtual->next;
-		}
-		atual = atual->proxVertice;
-		printf("\n");
+void DestroiArena(ArenaGrafo* arena) {
+	if (arena == NULL) return;
+	BlocoArena* bloco = arena->blocos;
+	while (bloco != NULL) {
+		BlocoArena* prox = bloco->proximo;
+		free(bloco);
+		bloco = prox;
 	}
+	arena->blocos = NULL;
+	arena->livre = NULL;
+	arena->restante = 0;
+	arena->verticesLivres = NULL;
+	arena->adjLivres = NULL;
 }
 
-
-
 #pragma endregion
 
-
-/**
- * @brief Carrega uma matriz de um ficheiro e a converte em um grafo.
- *
- * Esta funo l uma matriz de um ficheiro delimitado por ponto e vrgula,
- * cria um grafo a partir dos dados da matriz, onde cada clula no-nula
- * representa uma aresta com peso entre dois vrtices.Se a clula for nula
- * a aresta no ser implementada.
- *
- * @param fileName O nome do ficheiro que contem a matriz.
- * @param numLinhas Um apontador para um inteiro onde o nmero de linhas da matriz ser armazenado.
- * @param numColunas Um apontador para um inteiro onde o nmero de colunas da matriz ser armazenado.
- *
- * @return Um apontador para o grafo criado a partir da matriz, ou NULL em caso de erro.
- *
+/*
+ * Representao densa: operaes sobre a matriz de adjacncias.
  */
-Grafo* carregarMatrizParaGrafo(char fileName[], int* numLinhas, int* numColunas) {
-	FILE* fp;
-	char linha[MAXCHAR];
-	char* token;
+static MatrizDensa* CriaMatrizDensa(int numVertices) {
+	if (numVertices < 0) return NULL;
+	size_t celulas = (size_t)numVertices * (size_t)numVertices;
+	if (numVertices > 0 && celulas / (size_t)numVertices != (size_t)numVertices) return NULL;
+	if (celulas > (size_t)-1 / sizeof(int)) return NULL;
 
-	fp = fopen(fileName, "r");
-	if (fp == NULL) {
+	MatrizDensa* m = (MatrizDensa*)malloc(sizeof(MatrizDensa));
+	if (m == NULL) return NULL;
+	m->numVertices = numVertices;
+	m->palavrasLinha = (numVertices + 63) / 64;
+	m->pesos = (int*)calloc(celulas > 0 ? celulas : 1, sizeof(int));
+	m->presenca = (unsigned long long*)calloc((size_t)numVertices * m->palavrasLinha + 1, sizeof(unsigned long long));
+	if (m->pesos == NULL || m->presenca == NULL) {
+		free(m->pesos);
+		free(m->presenca);
+		free(m);
 		return NULL;
 	}
+	return m;
+}
 
-	*numLinhas = 0;
-	*numColunas = 0;
 
-	Grafo* grafo = CriaGrafo();
-	if (grafo == NULL) {
-		fclose(fp);
-		return NULL;
-	}
-	// ciclo para ler cada linha do arquivo
-	while (fgets(linha, MAXCHAR, fp) != NULL) {
-		// Incrementa o nmero de linhas
-		(*numLinhas)++;
-		token = strtok(linha, ";");
-		int colunaAtual = 0;
-		while (token != NULL) {
-			int valor = atoi(token);
-			if (valor != 0) {
-				// Verifica se o vrtice de origem existe, se no, cria
-				if (!ExisteVerticeGrafo(grafo, *numLinhas - 1)) {
-					Vertices* novoVertice = CriaVertice(*numLinhas - 1);
-					if (novoVertice == NULL) {
-						fclose(fp);
-						return NULL;
+static void DestroiMatrizDensa(MatrizDensa* m) {
+	if (m == NULL) return;
+	free(m->pesos);
+	free(m->presenca);
+	free(m);
+}
+
+
+static bool DentroMatrizDensa(MatrizDensa* m, int id) {
+	return id >= 0 && id < m->numVertices;
+}
+
+
+static bool ExisteArestaDensa(MatrizDensa* m, int origem, int destino) {
+	if (!DentroMatrizDensa(m, origem) || !DentroMatrizDensa(m, destino)) return false;
+	return (m->presenca[(size_t)origem * m->palavrasLinha + (destino >> 6)] >> (destino & 63)) & 1;
+}
+
+
+static void MarcaArestaDensa(MatrizDensa* m, int origem, int destino, int peso) {
+	m->pesos[(size_t)origem * m->numVertices + destino] = peso;
+	m->presenca[(size_t)origem * m->palavrasLinha + (destino >> 6)] |= 1ULL << (destino & 63);
+}
+
+
+static void LimpaArestaDensa(MatrizDensa* m, int origem, int destino) {
+	m->presenca[(size_t)origem * m->palavrasLinha + (destino >> 6)] &= ~(1ULL << (destino & 63));
+}
+
+
+#pragma region Grafo
+
+/**
+ * @brief Regista uma alterao do grafo no dirio e invalida os resultados guardados.
+ *
+ * Chamada antes de a alterao ser aplicada, depois de tudo o que pode falhar: se o registo
+ * no for escrito, a alterao no  feita e o grafo continua igual ao que est guardado.
+ *
+ * @return true se a alterao pode ser aplicada, false se o registo falhou.
+ */
+static bool RegistaAlteracao(Grafo* g, TipoRegistoDiario tipo, int origem, int destino, int peso) {
+	if (!RegistaDiario(g, tipo, origem, destino, peso)) return false;
+	g->versao++;
+	return true;
+}
+
+
+/**
+ * @brief Cria um novo grafo.
+ *
+ * Esta funo aloca dinamicamente memria para um novo grafo e inicializa seus campos.
+ *
+ * @return Um apontador para o novo grafo criado, ou NULL se a alocao de memria falhar.
+ */
+Grafo* CriaGrafo() {
+	Grafo* novoGrafo = (Grafo*)malloc(sizeof(Grafo));
+	if (novoGrafo == NULL) {
+		return NULL;
+	}
+
+	novoGrafo->inicioGrafo = NULL;
+	novoGrafo->indiceVertices = NULL;
+	novoGrafo->tamanhoIndice = 0;
+	novoGrafo->numIndexados = 0;
+	for (int k = 0; k < NIVEISINDICE; k++) {
+		novoGrafo->ocupados[k] = NULL;
+	}
+	novoGrafo->arena.blocos = NULL;
+	novoGrafo->arena.livre = NULL;
+	novoGrafo->arena.restante = 0;
+	novoGrafo->arena.verticesLivres = NULL;
+	novoGrafo->arena.adjLivres = NULL;
+	novoGrafo->diario = NULL;
+	novoGrafo->antecessores = NULL;
+	novoGrafo->arestas = NULL;
+	novoGrafo->densa = NULL;
+	novoGrafo->versao = 0;
+	novoGrafo->cache = NULL;
+
+	return novoGrafo;
+}
+
+
+/**
+ * @brief Destri um grafo e liberta toda a memria associada.
+ *
+ * Os vrtices e adjacncias reservados na arena so libertados em bloco; apenas os vrtices
+ * criados com CriaVertice e as adjacncias criadas com NovaAdjacencia e ligadas ao grafo so
+ * libertados um a um. Se o grafo tiver um dirio, este  fechado (sem compactar).
+ *
+ * @param g Um apontador para o grafo a destruir (pode ser NULL).
+ */
+void DestroiGrafo(Grafo* g) {
+	if (g == NULL) return;
+
+	FechaDiario(g);
+
+	Vertices* aux = g->inicioGrafo;
+	while (aux != NULL) {
+		Vertices* prox = aux->proxVertice;
+		Adjacencias* adj = aux->proxAdj;
+		while (adj != NULL) {
+			Adjacencias* proxAdj = adj->next;
+			if (!adj->daArena) free(adj);
+			adj = proxAdj;
+		}
+		if (!aux->daArena) free(aux);
+		aux = prox;
+	}
+
+	DestroiArena(&g->arena);
+	free(g->indiceVertices);
+	for (int k = 0; k < NIVEISINDICE; k++) {
+		free(g->ocupados[k]);
+	}
+	free(g->antecessores);
+	DesativaTabelaArestas(g);
+	DestroiMatrizDensa(g->densa);
+	DesativaCacheCaminhos(g);
+	free(g);
+}
+
+
+/**
+ * @brief Marca uma posio da tabela de ndice como ocupada no mapa de ocupao.
+ */
+static void MarcaOcupado(Grafo* g, int id) {
+	for (int k = 0; k < NIVEISINDICE; k++) {
+		unsigned long long* palavra = &g->ocupados[k][id >> 6];
+		bool jaOcupada = (*palavra != 0);
+		*palavra |= 1ULL << (id & 63);
+		if (jaOcupada) return; // os nveis de cima j a marcam
+		id >>= 6;
+	}
+}
+
+
+/**
+ * @brief Marca uma posio da tabela de ndice como livre no mapa de ocupao.
+ */
+static void LimpaOcupado(Grafo* g, int id) {
+	for (int k = 0; k < NIVEISINDICE; k++) {
+		unsigned long long* palavra = &g->ocupados[k][id >> 6];
+		*palavra &= ~(1ULL << (id & 63));
+		if (*palavra != 0) return;
+		id >>= 6;
+	}
+}
+
+
+/**
+ * @brief Devolve o maior id indexado abaixo de um limite, subindo e descendo o mapa de ocupao.
+ *
+ * @return O id encontrado, ou -1 se no houver nenhum.
+ */
+static int IdAnteriorIndice(const Grafo* g, int limite) {
+	if (limite > g->tamanhoIndice) limite = g->tamanhoIndice;
+
+	// Sobe at encontrar, num nvel, uma posio ocupada abaixo do limite
+	int pos = limite;
+	int k = 0;
+	for (;; k++) {
+		if (k == NIVEISINDICE || pos <= 0) return -1;
+		pos--;
+		unsigned long long palavra = g->ocupados[k][pos >> 6] & (~0ULL >> (63 - (pos & 63)));
+		if (palavra != 0) {
+			pos = ((pos >> 6) << 6) + BitMaisSignificativo(palavra);
+			break;
+		}
+		pos >>= 6;
+	}
+	// Desce pelo bit mais significativo de cada palavra
+	while (k > 0) {
+		k--;
+		pos = (pos << 6) + BitMaisSignificativo(g->ocupados[k][pos]);
+	}
+	return pos;
+}
+
+
+/**
+ * @brief Devolve o vrtice que precede um id na lista de vrtices do grafo.
+ *
+ * O de maior id indexado abaixo  encontrado no mapa de ocupao; a lista s  percorrida
+ * nos vrtices que no esto na tabela (ids negativos ou alm do seu tamanho).
+ *
+ * @return O vrtice anterior, ou NULL se o id ficar no incio da lista.
+ */
+static Vertices* VerticeAnterior(Grafo* g, int id) {
+	Vertices* ant = NULL;
+	int i = IdAnteriorIndice(g, id);
+	if (i >= 0) ant = g->indiceVertices[i];
+
+	Vertices* prox = (ant == NULL) ? g->inicioGrafo : ant->proxVertice;
+	while (prox != NULL && prox->id < id) {
+		ant = prox;
+		prox = prox->proxVertice;
+	}
+	return ant;
+}
+
+
+/**
+ * @brief Faz crescer a tabela de ndice at conter um id, se ficar com densidade suficiente.
+ *
+ * A tabela cresce para o dobro at o id caber, sem ultrapassar MAXINDICE. Acima de
+ * MINIMOINDICE posies s cresce se ficar com pelo menos um vrtice por cada FATORINDICE
+ * posies, contando com os que vo ser inseridos; caso contrrio os ids que no cabem
+ * ficam apenas na lista. Os vrtices da lista que passam a caber so indexados.
+ *
+ * @param numNovos O nmero de vrtices que vo ser indexados a seguir.
+ */
+static bool AumentaIndiceVertices(Grafo* g, int idMaximo, int numNovos) {
+	if (idMaximo < 0 || idMaximo >= MAXINDICE) return false;
+	if (idMaximo < g->tamanhoIndice) return true;
+
+	int antigo = g->tamanhoIndice;
+	int novoTamanho = (antigo == 0) ? 16 : antigo;
+	while (novoTamanho <= idMaximo) {
+		novoTamanho *= 2;
+	}
+	if (novoTamanho > MAXINDICE) novoTamanho = MAXINDICE;
+	if (novoTamanho > MINIMOINDICE && novoTamanho / FATORINDICE > (long long)g->numIndexados + numNovos) return false;
+
+	Vertices** novo = (Vertices**)realloc(g->indiceVertices, novoTamanho * sizeof(Vertices*));
+	if (novo == NULL) return false;
+	for (int i = antigo; i < novoTamanho; i++) {
+		novo[i] = NULL;
+	}
+	g->indiceVertices = novo;
+
+	// Mapa de ocupao: a palavra i do nvel k cobre as posies [i, i + 1) << 6(k + 1)
+	for (int k = 0; k < NIVEISINDICE; k++) {
+		int deslocamento = 6 * (k + 1);
+		int palavrasAntigas = (antigo == 0) ? 0 : ((antigo - 1) >> deslocamento) + 1;
+		int palavras = ((novoTamanho - 1) >> deslocamento) + 1;
+		unsigned long long* ocupados = (unsigned long long*)realloc(g->ocupados[k], palavras * sizeof(unsigned long long));
+		if (ocupados == NULL) return false;
+		for (int i = palavrasAntigas; i < palavras; i++) {
+			ocupados[i] = 0;
+		}
+		g->ocupados[k] = ocupados;
+	}
+
+	// O ndice inverso acompanha o tamanho da tabela
+	if (g->antecessores != NULL) {
+		Adjacencias** antecessores = (Adjacencias**)realloc(g->antecessores, novoTamanho * sizeof(Adjacencias*));
+		if (antecessores == NULL) {
+			DesativaAntecessores(g);
+		}
+		else {
+			for (int i = antigo; i < novoTamanho; i++) {
+				antecessores[i] = NULL;
+			}
+			g->antecessores = antecessores;
+		}
+	}
+
+	// Indexa os vrtices que estavam s na lista e passam a caber na tabela
+	Vertices* v = VerticeAnterior(g, antigo);
+	v = (v == NULL) ? g->inicioGrafo : v->proxVertice;
+	g->tamanhoIndice = novoTamanho;
+	for (; v != NULL && v->id < novoTamanho; v = v->proxVertice) {
+		g->indiceVertices[v->id] = v;
+		MarcaOcupado(g, v->id);
+		g->numIndexados++;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Regista um vrtice na tabela de ndice do grafo.
+ *
+ * A tabela associa cada id em [0, tamanhoIndice) ao respetivo vrtice, permitindo
+ * encontr-lo em tempo constante. A tabela cresce para o dobro quando o id no cabe,
+ * desde que fique com densidade suficiente (ver FATORINDICE). Ids negativos, superiores
+ * a MAXINDICE ou que no cabem na tabela no so indexados e continuam a ser procurados
+ * na lista de vrtices.
+ *
+ * @param g Um apontador para o grafo.
+ * @param v Um apontador para o vrtice a registar.
+ * @return true se o vrtice ficou indexado, false caso contrrio.
+ */
+bool RegistaVerticeIndice(Grafo* g, Vertices* v) {
+	if (g == NULL || v == NULL) return false;
+	if (!AumentaIndiceVertices(g, v->id, 1)) return false;
+
+	if (g->indiceVertices[v->id] == NULL) {
+		MarcaOcupado(g, v->id);
+		g->numIndexados++;
+	}
+	g->indiceVertices[v->id] = v;
+	return true;
+}
+
+
+/**
+ * @brief Garante que a tabela de ndice do grafo tem posio para um id.
+ *
+ * A tabela cresce para o dobro at o id caber, sem ultrapassar MAXINDICE, e recusa crescer
+ * se ficar com menos de um vrtice por cada FATORINDICE posies.
+ *
+ * @param g Um apontador para o grafo.
+ * @param idMaximo O maior id que a tabela tem de conter.
+ * @return true se o id cabe na tabela, false se for invlido, a tabela ficar demasiado
+ *         esparsa ou a alocao falhar.
+ */
+bool ReservaIndiceVertices(Grafo* g, int idMaximo) {
+	if (g == NULL) return false;
+	return AumentaIndiceVertices(g, idMaximo, 1);
+}
+
+
+/**
+ * @brief Remove um vrtice da tabela de ndice do grafo.
+ *
+ * @param g Um apontador para o grafo.
+ * @param idVertice O identificador do vrtice a remover do ndice.
+ */
+void RemoveVerticeIndice(Grafo* g, int idVertice) {
+	if (g == NULL) return;
+	if (idVertice >= 0 && idVertice < g->tamanhoIndice && g->indiceVertices[idVertice] != NULL) {
+		g->indiceVertices[idVertice] = NULL;
+		LimpaOcupado(g, idVertice);
+		g->numIndexados--;
+	}
+}
+
+
+/**
+ * @brief Regista no ndice inverso a aresta origem -> destino; desativa o ndice se no for possvel.
+ */
+static bool AcrescentaAntecessor(Grafo* g, int destino, int origem, int peso) {
+	if (g->antecessores == NULL) return false;
+	if (destino < 0 || destino >= g->tamanhoIndice || origem < 0 || origem >= g->tamanhoIndice) {
+		DesativaAntecessores(g);
+		return false;
+	}
+	Adjacencias* nova = NovaAdjacenciaArena(g, origem, peso);
+	if (nova == NULL) {
+		DesativaAntecessores(g);
+		return false;
+	}
+	nova->next = g->antecessores[destino];
+	g->antecessores[destino] = nova;
+	return true;
+}
+
+
+/**
+ * @brief Remove do ndice inverso uma aresta origem -> destino.
+ *
+ * Como as entradas esto pela ordem inversa, a ltima ocorrncia da origem corresponde 
+ * primeira aresta da lista de adjacncias, que  a removida por EliminaAdjArena.
+ */
+static void RemoveAntecessor(Grafo* g, int destino, int origem) {
+	if (g->antecessores == NULL || destino < 0 || destino >= g->tamanhoIndice) return;
+
+	Adjacencias* ant = NULL;
+	Adjacencias* antAlvo = NULL;
+	Adjacencias* alvo = NULL;
+	for (Adjacencias* adj = g->antecessores[destino]; adj != NULL; adj = adj->next) {
+		if (adj->id == origem) {
+			alvo = adj;
+			antAlvo = ant;
+		}
+		ant = adj;
+	}
+	if (alvo == NULL) return;
+	if (antAlvo == NULL) g->antecessores[destino] = alvo->next;
+	else antAlvo->next = alvo->next;
+	LibertaAdjacenciaArena(g, alvo);
+}
+
+
+/**
+ * @brief Ativa o ndice inverso do grafo, com as arestas de entrada de cada vrtice.
+ *
+ * Enquanto estiver ativo, o ndice  mantido por InsereAdjacenciasGrafo, InsereArestasGrafo,
+ * EliminaAdjGrafo e EliminaVerticeGrafo, e este ltimo passa a visitar apenas os antecessores
+ * do vrtice em vez de todas as listas de adjacncias. As alteraes feitas diretamente s
+ * listas (por exemplo com InsereAdj) no so acompanhadas. S vrtices guardados na tabela
+ * de ndice so suportados; se aparecer outro, o ndice  desativado. Um grafo
+ * na representao densa passa primeiro para listas.
+ *
+ * @param g Um apontador para o grafo.
+ * @return true se o ndice ficou ativo, false caso contrrio.
+ */
+bool AtivaAntecessores(Grafo* g) {
+	if (g == NULL) return false;
+	if (g->antecessores != NULL) return true;
+	if (!ConverteGrafoListas(g)) return false;
+
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		if (v->id < 0 || v->id >= g->tamanhoIndice) return false;
+	}
+
+	g->antecessores = (Adjacencias**)calloc(g->tamanhoIndice > 0 ? g->tamanhoIndice : 1, sizeof(Adjacencias*));
+	if (g->antecessores == NULL) return false;
+
+	// As entradas so acrescentadas no incio, por isso ficam pela ordem inversa das arestas
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		for (Adjacencias* adj = v->proxAdj; adj != NULL; adj = adj->next) {
+			if (!AcrescentaAntecessor(g, adj->id, v->id, adj->peso)) return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Desativa o ndice inverso e devolve os seus ns  arena.
+ *
+ * @param g Um apontador para o grafo.
+ */
+void DesativaAntecessores(Grafo* g) {
+	if (g == NULL || g->antecessores == NULL) return;
+
+	for (int i = 0; i < g->tamanhoIndice; i++) {
+		Adjacencias* adj = g->antecessores[i];
+		while (adj != NULL) {
+			Adjacencias* prox = adj->next;
+			LibertaAdjacenciaArena(g, adj);
+			adj = prox;
+		}
+	}
+	free(g->antecessores);
+	g->antecessores = NULL;
+}
+
+
+/**
+ * @brief Devolve as arestas de entrada de um vrtice.
+ *
+ * Cada elemento da lista tem como id a origem da aresta e o respetivo peso; uma origem com
+ * vrias arestas para o vrtice aparece vrias vezes. A lista pertence ao grafo e no deve
+ * ser alterada.
+ *
+ * @param g Um apontador para o grafo, com o ndice inverso ativo (ver AtivaAntecessores).
+ * @param idVertice O identificador do vrtice.
+ * @return A lista de antecessores, ou NULL se no houver nenhum ou o ndice no estiver ativo.
+ */
+Adjacencias* AntecessoresGrafo(Grafo* g, int idVertice) {
+	if (g == NULL || g->antecessores == NULL) return NULL;
+	if (idVertice < 0 || idVertice >= g->tamanhoIndice) return NULL;
+	return g->antecessores[idVertice];
+}
+
+
+/**
+ * @brief Prepara um quadro da procura para percorrer as adjacncias de um vrtice.
+ */
+static void IniciaQuadro(Grafo* g, int v, int soma, QuadroDFS* quadro) {
+	quadro->vertice = v;
+	quadro->soma = soma;
+	quadro->coluna = 0;
+	quadro->cursor = NULL;
+	if (g->densa == NULL) {
+		Vertices* verticeAtual = OndeEstaVerticeGrafo(g, v);
+		quadro->cursor = (verticeAtual != NULL) ? verticeAtual->proxAdj : NULL;
+	}
+}
+
+
+/**
+ * @brief Avana um quadro at  prxima adjacncia cujo destino ainda no foi visitado.
+ *
+ * Com listas, segue o cursor; na representao densa, percorre a linha do mapa de presena
+ * palavra a palavra, saltando diretamente para cada bit a 1.
+ *
+ * @return true se encontrou uma adjacncia (destino e peso), false se o vrtice no tem mais.
+ */
+static bool ProximaAdjacencia(Grafo* g, QuadroDFS* quadro, const bool* visitado, int* destino, int* peso) {
+	MatrizDensa* m = g->densa;
+	if (m == NULL) {
+		Adjacencias* adj = quadro->cursor;
+		while (adj != NULL && visitado[adj->id]) {
+			adj = adj->next;
+		}
+		if (adj == NULL) {
+			quadro->cursor = NULL;
+			return false;
+		}
+		quadro->cursor = adj->next;
+		*destino = adj->id;
+		*peso = adj->peso;
+		return true;
+	}
+
+	int v = quadro->vertice;
+	if (v < 0 || v >= m->numVertices) return false;
+	const unsigned long long* linha = m->presenca + (size_t)v * m->palavrasLinha;
+	int c = quadro->coluna;
+	while (c < m->numVertices) {
+		unsigned long long palavra = linha[c >> 6] & (~0ULL << (c & 63));
+		while (palavra != 0) {
+			int j = ((c >> 6) << 6) + BitMenosSignificativo(palavra);
+			if (!visitado[j]) {
+				quadro->coluna = j + 1;
+				*destino = j;
+				*peso = m->pesos[(size_t)v * m->numVertices + j];
+				return true;
+			}
+			palavra &= palavra - 1;
+		}
+		c = ((c >> 6) + 1) << 6;
+	}
+	quadro->coluna = m->numVertices;
+	return false;
+}
+
+
+/**
+ * @brief Passa um grafo para a representao densa (matriz de adjacncias).
+ *
+ * A matriz tem uma linha e uma coluna por id, de 0 ao maior id do grafo, e as adjacncias
+ * passam a ser consultadas e percorridas na matriz, mantendo a ordem das colunas. S 
+ * possvel se todos os ids forem no negativos, no houver arestas repetidas e nenhum dos
+ * ndices opcionais (antecessores, tabela de arestas) estiver ativo.
+ *
+ * @param g Um apontador para o grafo.
+ * @return true se o grafo ficou denso, false caso contrrio (o grafo no  alterado).
+ */
+bool ConverteGrafoDenso(Grafo* g) {
+	if (g == NULL) return false;
+	if (g->densa != NULL) return true;
+	if (g->antecessores != NULL || g->arestas != NULL) return false;
+
+	int maiorId = -1;
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		if (v->id < 0) return false;
+		if (v->id > maiorId) maiorId = v->id;
+	}
+	MatrizDensa* m = CriaMatrizDensa(maiorId + 1);
+	if (m == NULL) return false;
+
+	// A ordem das adjacncias tem de ser a das colunas, sem repeties
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		int anterior = -1;
+		for (Adjacencias* adj = v->proxAdj; adj != NULL; adj = adj->next) {
+			if (adj->id <= anterior || adj->id > maiorId) {
+				DestroiMatrizDensa(m);
+				return false;
+			}
+			anterior = adj->id;
+			MarcaArestaDensa(m, v->id, adj->id, adj->peso);
+		}
+	}
+
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		Adjacencias* adj = v->proxAdj;
+		while (adj != NULL) {
+			Adjacencias* prox = adj->next;
+			LibertaAdjacenciaArena(g, adj);
+			adj = prox;
+		}
+		v->proxAdj = NULL;
+	}
+	g->densa = m;
+	g->versao++; // a ordem das adjacncias passa a ser a das colunas
+	return true;
+}
+
+
+/**
+ * @brief Passa um grafo da representao densa para listas de adjacncias.
+ *
+ * Usada automaticamente quando uma operao no  possvel na matriz (por exemplo, uma aresta
+ * repetida ou para um vrtice fora da matriz).
+ *
+ * @param g Um apontador para o grafo.
+ * @return true se o grafo ficou com listas, false se a alocao falhar (o grafo no  alterado).
+ */
+bool ConverteGrafoListas(Grafo* g) {
+	if (g == NULL) return false;
+	MatrizDensa* m = g->densa;
+	if (m == NULL) return true;
+
+	bool ok = true;
+	for (Vertices* v = g->inicioGrafo; v != NULL && ok; v = v->proxVertice) {
+		if (!DentroMatrizDensa(m, v->id)) continue;
+		Adjacencias* cauda = NULL;
+		for (int j = 0; j < m->numVertices; j++) {
+			if (!ExisteArestaDensa(m, v->id, j)) continue;
+			Adjacencias* adj = NovaAdjacenciaArena(g, j, m->pesos[(size_t)v->id * m->numVertices + j]);
+			if (adj == NULL) {
+				ok = false;
+				break;
+			}
+			if (cauda == NULL) v->proxAdj = adj;
+			else cauda->next = adj;
+			cauda = adj;
+		}
+	}
+
+	if (!ok) {
+		// Desfaz as listas j criadas
+		for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+			Adjacencias* adj = v->proxAdj;
+			while (adj != NULL) {
+				Adjacencias* prox = adj->next;
+				LibertaAdjacenciaArena(g, adj);
+				adj = prox;
+			}
+			v->proxAdj = NULL;
+		}
+		return false;
+	}
+
+	DestroiMatrizDensa(m);
+	g->densa = NULL;
+	g->versao++;
+	return true;
+}
+
+
+static size_t PosicaoAresta(TabelaArestas* tabela, int origem, int destino) {
+	unsigned long long h = ((unsigned long long)(unsigned int)origem << 32) | (unsigned int)destino;
+	h *= 0x9E3779B97F4A7C15ULL;
+	return (size_t)(h >> 32) & (tabela->capacidade - 1);
+}
+
+
+static EntradaAresta* ProcuraEntradaAresta(TabelaArestas* tabela, int origem, int destino) {
+	size_t i = PosicaoAresta(tabela, origem, destino);
+	while (tabela->entradas[i].adj != NULL) {
+		if (tabela->entradas[i].origem == origem && tabela->entradas[i].destino == destino) {
+			return &tabela->entradas[i];
+		}
+		i = (i + 1) & (tabela->capacidade - 1);
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief Regista a adjacncia origem -> destino na tabela de arestas, se ainda no houver nenhuma.
+ *
+ * A tabela cresce para o dobro quando passa de metade da capacidade; se no for possvel,
+ *  desativada.
+ */
+static void TabelaAcrescentaAresta(Grafo* g, int origem, Adjacencias* adj) {
+	TabelaArestas* tabela = g->arestas;
+	if (tabela == NULL) return;
+
+	if (2 * (tabela->ocupadas + 1) > tabela->capacidade) {
+		EntradaAresta* antigas = tabela->entradas;
+		size_t capacidadeAntiga = tabela->capacidade;
+		tabela->entradas = (EntradaAresta*)calloc(2 * capacidadeAntiga, sizeof(EntradaAresta));
+		if (tabela->entradas == NULL) {
+			tabela->entradas = antigas;
+			DesativaTabelaArestas(g);
+			return;
+		}
+		tabela->capacidade = 2 * capacidadeAntiga;
+		for (size_t i = 0; i < capacidadeAntiga; i++) {
+			if (antigas[i].adj == NULL) continue;
+			size_t j = PosicaoAresta(tabela, antigas[i].origem, antigas[i].destino);
+			while (tabela->entradas[j].adj != NULL) {
+				j = (j + 1) & (tabela->capacidade - 1);
+			}
+			tabela->entradas[j] = antigas[i];
+		}
+		free(antigas);
+	}
+
+	size_t i = PosicaoAresta(tabela, origem, adj->id);
+	while (tabela->entradas[i].adj != NULL) {
+		if (tabela->entradas[i].origem == origem && tabela->entradas[i].destino == adj->id) {
+			return; // j existe uma aresta anterior entre os dois vrtices
+		}
+		i = (i + 1) & (tabela->capacidade - 1);
+	}
+	tabela->entradas[i].origem = origem;
+	tabela->entradas[i].destino = adj->id;
+	tabela->entradas[i].adj = adj;
+	tabela->ocupadas++;
+}
+
+
+/**
+ * @brief Atualiza a entrada origem -> destino depois de remover adjacncias da lista da origem.
+ *
+ * A entrada passa a apontar para a prxima adjacncia com o mesmo destino ou, se no houver,
+ *  retirada da tabela, deslocando para trs as entradas seguintes da mesma sequncia.
+ *
+ * @param g Um apontador para o grafo.
+ * @param origem O vrtice de origem (NULL se j no existir).
+ * @param idOrigem O id do vrtice de origem.
+ * @param destino O id do vrtice de destino.
+ */
+static void TabelaAtualizaAresta(Grafo* g, Vertices* origem, int idOrigem, int destino) {
+	TabelaArestas* tabela = g->arestas;
+	if (tabela == NULL) return;
+
+	EntradaAresta* entrada = ProcuraEntradaAresta(tabela, idOrigem, destino);
+	if (entrada == NULL) return;
+
+	Adjacencias* adj = (origem != NULL) ? origem->proxAdj : NULL;
+	while (adj != NULL && adj->id != destino) {
+		adj = adj->next;
+	}
+	if (adj != NULL) {
+		entrada->adj = adj;
+		return;
+	}
+
+	// Remoo com deslocamento para trs, sem marcas de posio apagada
+	size_t mascara = tabela->capacidade - 1;
+	size_t i = (size_t)(entrada - tabela->entradas);
+	size_t j = i;
+	while (true) {
+		j = (j + 1) & mascara;
+		if (tabela->entradas[j].adj == NULL) break;
+		size_t k = PosicaoAresta(tabela, tabela->entradas[j].origem, tabela->entradas[j].destino);
+		// A entrada j s pode ocupar a posio i se i estiver entre k e j (circularmente)
+		if ((j > i && (k <= i || k > j)) || (j < i && (k <= i && k > j))) {
+			tabela->entradas[i] = tabela->entradas[j];
+			i = j;
+		}
+	}
+	tabela->entradas[i].adj = NULL;
+	tabela->ocupadas--;
+}
+
+
+/**
+ * @brief Ativa a tabela de arestas do grafo, que associa cada par (origem, destino)  respetiva adjacncia.
+ *
+ * Com a tabela ativa, PesoAresta responde em tempo constante, em vez de percorrer a lista de
+ * adjacncias da origem. A tabela  mantida por InsereAdjacenciasGrafo, InsereArestasGrafo,
+ * EliminaAdjGrafo e EliminaVerticeGrafo; as alteraes feitas diretamente s listas no so
+ * acompanhadas. Havendo vrias arestas entre os mesmos vrtices, a tabela guarda a primeira.
+ * Um grafo na representao densa passa primeiro para listas.
+ *
+ * @param g Um apontador para o grafo.
+ * @return true se a tabela ficou ativa, false se a alocao falhar.
+ */
+bool AtivaTabelaArestas(Grafo* g) {
+	if (g == NULL) return false;
+	if (g->arestas != NULL) return true;
+	if (!ConverteGrafoListas(g)) return false;
+
+	size_t numArestas = 0;
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		for (Adjacencias* adj = v->proxAdj; adj != NULL; adj = adj->next) {
+			numArestas++;
+		}
+	}
+	size_t capacidade = 16;
+	while (capacidade < 2 * numArestas + 2) {
+		capacidade *= 2;
+	}
+
+	g->arestas = (TabelaArestas*)malloc(sizeof(TabelaArestas));
+	if (g->arestas == NULL) return false;
+	g->arestas->entradas = (EntradaAresta*)calloc(capacidade, sizeof(EntradaAresta));
+	if (g->arestas->entradas == NULL) {
+		free(g->arestas);
+		g->arestas = NULL;
+		return false;
+	}
+	g->arestas->capacidade = capacidade;
+	g->arestas->ocupadas = 0;
+
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		for (Adjacencias* adj = v->proxAdj; adj != NULL; adj = adj->next) {
+			TabelaAcrescentaAresta(g, v->id, adj);
+		}
+	}
+	return g->arestas != NULL;
+}
+
+
+/**
+ * @brief Desativa e liberta a tabela de arestas do grafo.
+ *
+ * @param g Um apontador para o grafo.
+ */
+void DesativaTabelaArestas(Grafo* g) {
+	if (g == NULL || g->arestas == NULL) return;
+	free(g->arestas->entradas);
+	free(g->arestas);
+	g->arestas = NULL;
+}
+
+
+/**
+ * @brief Obtm o peso da aresta entre dois vrtices.
+ *
+ * Na representao densa ou com a tabela de arestas ativa (ver AtivaTabelaArestas), a consulta
+ *  feita em tempo constante; caso contrrio,  percorrida a lista de adjacncias da origem. Havendo vrias
+ * arestas entre os mesmos vrtices,  devolvido o peso da primeira.
+ *
+ * @param g Um apontador para o grafo.
+ * @param origem O identificador do vrtice de origem.
+ * @param destino O identificador do vrtice de destino.
+ * @param peso Apontador para o peso da aresta (pode ser NULL).
+ * @return true se a aresta existe, false caso contrrio.
+ */
+bool PesoAresta(Grafo* g, int origem, int destino, int* peso) {
+	if (g == NULL) return false;
+
+	if (g->densa != NULL) {
+		if (!ExisteArestaDensa(g->densa, origem, destino)) return false;
+		if (peso != NULL) *peso = g->densa->pesos[(size_t)origem * g->densa->numVertices + destino];
+		return true;
+	}
+
+	Adjacencias* adj = NULL;
+	if (g->arestas != NULL) {
+		EntradaAresta* entrada = ProcuraEntradaAresta(g->arestas, origem, destino);
+		if (entrada != NULL) adj = entrada->adj;
+	}
+	else {
+		Vertices* v = OndeEstaVerticeGrafo(g, origem);
+		adj = (v != NULL) ? v->proxAdj : NULL;
+		while (adj != NULL && adj->id != destino) {
+			adj = adj->next;
+		}
+	}
+
+	if (adj == NULL) return false;
+	if (peso != NULL) *peso = adj->peso;
+	return true;
+}
+
+
+
+/**
+ * @brief Verifica se um vrtice com o identificador especifico existe no grafo.
+ *
+ * Esta funo verifica se um vrtice com o identificador especifico existe no grafo.
+ *
+ * @param g Um apontador para o grafo.
+ * @param idVertice O identificador do vrtice a ser verificado.
+ * @return true se um vrtice com o identificador especificado existir no grafo, false caso contrrio.
+ */
+bool ExisteVerticeGrafo(Grafo* g, int idVertice) {
+	return (OndeEstaVerticeGrafo(g, idVertice) != NULL);
+}
+
+
+/**
+ * @brief Insere um novo vrtice no grafo.
+ *
+ * Esta funo insere um novo vrtice no grafo, realizando algumas validaes.
+ *
+ * @param g Um apontador para o grafo.
+ * @param novo Um apontador para o vrtice a ser inserido.
+ * @param res Um ponteiro para uma varivel inteira que indica o resultado da operao:
+ *            1 - insero bem-sucedida,
+ *            0 - vrtice invlido,
+ *           -1 - grafo vazio,
+ *           -2 - vrtice j existente no grafo.
+ * @return Um apontador para o grafo aps a insero do vrtice.
+ */
+Grafo* InsereVerticeGrafo(Grafo* g, Vertices* novo, int* res) {
+	*res = 1;
+	if (novo == NULL) { //vertice invalido
+		*res = 0;
+		return g;
+	}
+	if (g == NULL) { // grafo vazio
+		*res = -1;
+		return NULL;
+	}
+	//verificar se V j existe no grafo...
+	if (ExisteVerticeGrafo(g, novo->id)) { //vertice desconhecido
+		*res = -2;
+		return g;
+	}
+
+	// A matriz densa s tem ids no negativos
+	if (g->densa != NULL && novo->id < 0 && !ConverteGrafoListas(g)) {
+		*res = 0;
+		return g;
+	}
+
+	if (!RegistaAlteracao(g, DIARIO_INSERE_VERTICE, novo->id, 0, 0)) {
+		*res = 0;
+		return g;
+	}
+
+	// O vrtice anterior  encontrado pelo mapa de ocupao do ndice, sem percorrer a lista
+	Vertices* ant = VerticeAnterior(g, novo->id);
+	if (ant != NULL) {
+		novo->proxVertice = ant->proxVertice;
+		ant->proxVertice = novo;
+	}
+	else {
+		novo->proxVertice = g->inicioGrafo;
+		g->inicioGrafo = novo;
+	}
+
+	// Sem lugar na tabela (id negativo ou demasiado esparso) fica s na lista
+	if (!RegistaVerticeIndice(g, novo)) DesativaAntecessores(g); // id fora do ndice inverso
+	return g;
+}
+
+
+/**
+ * @brief Encontra um vrtice com o identificador especificado no grafo.
+ *
+ * Esta funo verifica se um vrtice com o identificador especificado existe no grafo e retorna um apontador para ele.
+ *
+ * @param g Um apontador para o grafo.
+ * @param idVertice O identificador do vrtice a ser encontrado.
+ * @return Um apontador para o vrtice com o identificador especificado, ou NULL se no for encontrado.
+ */
+Vertices* OndeEstaVerticeGrafo(Grafo* g, int idVertice) {
+	if (g == NULL) return NULL;
+	if (idVertice >= 0 && idVertice < g->tamanhoIndice) {
+		return g->indiceVertices[idVertice];
+	}
+	// Fora da tabela: s  percorrida a parte da lista que no est indexada
+	Vertices* ant = VerticeAnterior(g, idVertice);
+	Vertices* v = (ant == NULL) ? g->inicioGrafo : ant->proxVertice;
+	return (v != NULL && v->id == idVertice) ? v : NULL;
+}
+
+
+/**
+ * @brief Desliga um vrtice da lista e remove as arestas que apontam para ele, percorrendo todas as listas.
+ */
+static void EliminaVerticeListas(Grafo* g, Vertices* alvo) {
+	int codVertice = alvo->id;
+
+	// Percorre os vrtices uma vez: desliga o alvo e remove as adjacncias que apontam para ele
+	Vertices* ant = NULL;
+	Vertices* aux = g->inicioGrafo;
+	while (aux != NULL) {
+		if (aux == alvo) {
+			if (ant == NULL) {
+				g->inicioGrafo = aux->proxVertice;
+			}
+			else {
+				ant->proxVertice = aux->proxVertice;
+			}
+		}
+		else {
+			bool removida = true;
+			bool alguma = false;
+			while (removida) {
+				aux->proxAdj = EliminaAdjArena(g, aux->proxAdj, codVertice, &removida);
+				alguma = alguma || removida;
+			}
+			if (alguma) TabelaAtualizaAresta(g, aux, aux->id, codVertice);
+			ant = aux;
+		}
+		aux = aux->proxVertice;
+	}
+}
+
+
+/**
+ * @brief Desliga um vrtice da lista e remove as arestas que apontam para ele, usando o ndice inverso.
+ *
+ * S so visitadas as listas dos antecessores do vrtice e as entradas inversas dos seus
+ * sucessores; o vrtice anterior na lista  encontrado pela tabela de ndice.
+ */
+static void EliminaVerticeAntecessores(Grafo* g, Vertices* alvo) {
+	int codVertice = alvo->id;
+
+	// Arestas de entrada: uma remoo na lista do antecessor por cada entrada
+	Adjacencias* entrada = g->antecessores[codVertice];
+	while (entrada != NULL) {
+		Adjacencias* prox = entrada->next;
+		if (entrada->id != codVertice) {
+			Vertices* origem = g->indiceVertices[entrada->id];
+			bool removida;
+			origem->proxAdj = EliminaAdjArena(g, origem->proxAdj, codVertice, &removida);
+			TabelaAtualizaAresta(g, origem, entrada->id, codVertice);
+		}
+		LibertaAdjacenciaArena(g, entrada);
+		entrada = prox;
+	}
+	g->antecessores[codVertice] = NULL;
+
+	// Arestas de sada: retira o vrtice das entradas inversas dos sucessores
+	for (Adjacencias* adj = alvo->proxAdj; adj != NULL; adj = adj->next) {
+		if (adj->id != codVertice) RemoveAntecessor(g, adj->id, codVertice);
+	}
+
+	// O vrtice anterior na lista  o de maior id indexado abaixo deste
+	Vertices* ant = VerticeAnterior(g, codVertice);
+	if (ant == NULL) g->inicioGrafo = alvo->proxVertice;
+	else ant->proxVertice = alvo->proxVertice;
+}
+
+
+/**
+ * @brief Remove um vrtice com o cdigo especificado do grafo, juntamente com todas as suas adjacncias.
+ *
+ * Esta funo remove um vrtice com o cdigo especificado do grafo, juntamente com todas as suas adjacncias.
+ * Com o ndice inverso ativo (ver AtivaAntecessores), s so visitadas as listas dos antecessores
+ * do vrtice; caso contrrio, so percorridas as listas de todos os vrtices.
+ *
+ * @param g Um apontador para o grafo.
+ * @param codVertice O cdigo do vrtice a ser removido.
+ * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
+ * @return Um apontador para o grafo aps a remoo do vrtice e suas adjacncias.
+ */
+Grafo* EliminaVerticeGrafo(Grafo* g, int codVertice, bool* res) {
+	*res = false;
+	if (g == NULL) return NULL;
+
+	Vertices* alvo = OndeEstaVerticeGrafo(g, codVertice);
+	if (alvo == NULL) return g; // Vertice no encontrado
+
+	if (g->densa != NULL && !DentroMatrizDensa(g->densa, codVertice) && !ConverteGrafoListas(g)) {
+		return g;
+	}
+	if (!RegistaAlteracao(g, DIARIO_ELIMINA_VERTICE, codVertice, 0, 0)) return g;
+	if (g->densa != NULL) {
+		// Limpa a linha e a coluna do vrtice na matriz
+		MatrizDensa* m = g->densa;
+		memset(m->presenca + (size_t)codVertice * m->palavrasLinha, 0, m->palavrasLinha * sizeof(unsigned long long));
+		for (int i = 0; i < m->numVertices; i++) {
+			LimpaArestaDensa(m, i, codVertice);
+		}
+	}
+	if (g->antecessores != NULL) {
+		EliminaVerticeAntecessores(g, alvo);
+	}
+	else {
+		EliminaVerticeListas(g, alvo);
+	}
+	for (Adjacencias* adj = alvo->proxAdj; adj != NULL && g->arestas != NULL; adj = adj->next) {
+		TabelaAtualizaAresta(g, NULL, codVertice, adj->id);
+	}
+
+	// Devolve  arena as adjacncias do vrtice eliminado e o prprio vrtice
+	Adjacencias* adj = alvo->proxAdj;
+	while (adj != NULL) {
+		Adjacencias* prox = adj->next;
+		LibertaAdjacenciaArena(g, adj);
+		adj = prox;
+	}
+	RemoveVerticeIndice(g, codVertice);
+	LibertaVerticeArena(g, alvo);
+
+	*res = true;
+	return g;
+}
+
+
+/**
+ * @brief Remove uma adjacncia entre dois vrtices do grafo.
+ *
+ * Esta funo remove uma adjacncia entre dois vrtices do grafo, se eles existirem.
+ *
+ * @param g Um apontador para o grafo.
+ * @param origem O identificador do vrtice de origem da adjacncia.
+ * @param destino O identificador do vrtice de destino da adjacncia.
+ * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
+ * @return Um apontador para o grafo aps a remoo da adjacncia entre os vrtices.
+ */
+Grafo* EliminaAdjGrafo(Grafo* g, int origem, int destino, bool* res) {
+
+	*res = false;
+
+	//validaes
+	if (g == NULL) return NULL;
+	//Verificar se vertices existem
+	Vertices* origemV = OndeEstaVerticeGrafo(g, origem);
+	if (origemV == NULL) return g;
+	Vertices* destinoV = OndeEstaVerticeGrafo(g, destino);
+	if (!destinoV) return g;
+
+	if (g->densa != NULL && (!DentroMatrizDensa(g->densa, origem) || !DentroMatrizDensa(g->densa, destino))
+		&& !ConverteGrafoListas(g)) {
+		return g;
+	}
+	if (g->densa != NULL) {
+		if (!ExisteArestaDensa(g->densa, origem, destino)) return g;
+		if (!RegistaAlteracao(g, DIARIO_ELIMINA_ADJ, origem, destino, 0)) return g;
+		LimpaArestaDensa(g->densa, origem, destino);
+		*res = true;
+		return g;
+	}
+
+	Adjacencias* adj = origemV->proxAdj;
+	while (adj != NULL && adj->id != destino) {
+		adj = adj->next;
+	}
+	if (adj == NULL || !RegistaAlteracao(g, DIARIO_ELIMINA_ADJ, origem, destino, 0)) return g;
+
+	origemV->proxAdj = EliminaAdjArena(g, origemV->proxAdj, destino, res);
+	if (*res) RemoveAntecessor(g, destino, origem);
+	if (*res) TabelaAtualizaAresta(g, origemV, origem, destino);
+	return g;
+}
+
+
+
+/**
+ * @brief Insere uma nova adjacncia entre dois vrtices no grafo.
+ *
+ * Esta funo insere uma nova adjacncia entre dois vrtices no grafo, se eles existirem.
+ *
+ * @param g Um apontador para o grafo.
+ * @param idOrigem O identificador do vrtice de origem da adjacncia.
+ * @param idDestino O identificador do vrtice de destino da adjacncia.
+ * @param peso O peso da adjacncia.
+ * @param res Um ponteiro para uma varivel booleana que indica se a operao foi bem-sucedida.
+ * @return Um apontador para o grafo aps a insero da adjacncia entre os vrtices.
+ */
+Grafo* InsereAdjacenciasGrafo(Grafo* g, int idOrigem, int idDestino, int peso, bool* res) {
+	if (res == NULL) {
+		return g;
+	}
+	*res = false;
+
+	if (g == NULL) {
+		return g;
+	}
+
+	// Verificar se os vrtices de origem e destino existem no grafo
+	Vertices* origemV = OndeEstaVerticeGrafo(g, idOrigem);
+	Vertices* destinoV = OndeEstaVerticeGrafo(g, idDestino);
+	if (origemV == NULL || destinoV == NULL) {
+		return g;
+	}
+
+	// Na matriz, se a clula estiver livre; seno (aresta repetida ou fora da matriz), passa a listas
+	if (g->densa != NULL) {
+		MatrizDensa* m = g->densa;
+		if (DentroMatrizDensa(m, idOrigem) && DentroMatrizDensa(m, idDestino) && !ExisteArestaDensa(m, idOrigem, idDestino)) {
+			if (!RegistaAlteracao(g, DIARIO_INSERE_ADJ, idOrigem, idDestino, peso)) return g;
+			MarcaArestaDensa(m, idOrigem, idDestino, peso);
+			*res = true;
+			return g;
+		}
+		if (!ConverteGrafoListas(g)) {
+			return g;
+		}
+	}
+
+	// Inserir a nova adjacncia, reservada na arena, no final da lista do vrtice de origem
+	Adjacencias* nova = NovaAdjacenciaArena(g, idDestino, peso);
+	if (nova == NULL) {
+		return g;
+	}
+	if (!RegistaAlteracao(g, DIARIO_INSERE_ADJ, idOrigem, idDestino, peso)) {
+		LibertaAdjacenciaArena(g, nova);
+		return g;
+	}
+	if (origemV->proxAdj == NULL) {
+		origemV->proxAdj = nova;
+	}
+	else {
+		Adjacencias* aux = origemV->proxAdj;
+		while (aux->next != NULL) {
+			aux = aux->next;
+		}
+		aux->next = nova;
+	}
+
+	if (g->antecessores != NULL) AcrescentaAntecessor(g, idDestino, idOrigem, peso);
+	TabelaAcrescentaAresta(g, idOrigem, nova);
+	*res = true;
+	return g;
+}
+
+
+static int ComparaInteiros(const void* a, const void* b) {
+	int x = *(const int*)a;
+	int y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+
+/**
+ * @brief Cria de uma s vez os vrtices em falta, inserindo-os na lista ordenada numa passagem.
+ *
+ * @return true se todos os vrtices foram criados, false se a alocao falhar.
+ */
+static bool CriaVerticesEmFalta(Grafo* g, const ArestaGrafo* arestas, int numArestas) {
+	int* ids = (int*)malloc(2 * (size_t)numArestas * sizeof(int));
+	if (ids == NULL) return false;
+
+	// Ids em falta, ordenados e sem repeties
+	int numIds = 0;
+	for (int i = 0; i < numArestas; i++) {
+		if (!ExisteVerticeGrafo(g, arestas[i].origem)) ids[numIds++] = arestas[i].origem;
+		if (!ExisteVerticeGrafo(g, arestas[i].destino)) ids[numIds++] = arestas[i].destino;
+	}
+	qsort(ids, numIds, sizeof(int), ComparaInteiros);
+	int numNovos = 0;
+	for (int i = 0; i < numIds; i++) {
+		if (numNovos == 0 || ids[i] != ids[numNovos - 1]) ids[numNovos++] = ids[i];
+	}
+	// A tabela de ndice cresce uma vez para o maior id novo, se ficar densa o suficiente;
+	// seno cada vrtice  registado  medida que  inserido
+	int maiorIndexado = -1;
+	int numIndexaveis = 0;
+	for (int i = numNovos - 1; i >= 0; i--) {
+		if (ids[i] < 0 || ids[i] >= MAXINDICE) continue;
+		if (maiorIndexado < 0) maiorIndexado = ids[i];
+		numIndexaveis++;
+	}
+	if (maiorIndexado >= 0) AumentaIndiceVertices(g, maiorIndexado, numIndexaveis);
+
+	// Intercala os novos vrtices na lista, que tambm est ordenada por id
+	bool ok = true;
+	Vertices* ant = NULL;
+	for (int i = 0; i < numNovos && ok; i++) {
+		Vertices* novo = CriaVerticeArena(g, ids[i]);
+		if (novo == NULL) {
+			ok = false;
+			break;
+		}
+		if (!RegistaAlteracao(g, DIARIO_INSERE_VERTICE, novo->id, 0, 0)) {
+			LibertaVerticeArena(g, novo);
+			ok = false;
+			break;
+		}
+		Vertices* prox = (ant == NULL) ? g->inicioGrafo : ant->proxVertice;
+		while (prox != NULL && prox->id < novo->id) {
+			ant = prox;
+			prox = prox->proxVertice;
+		}
+		novo->proxVertice = prox;
+		if (ant == NULL) g->inicioGrafo = novo;
+		else ant->proxVertice = novo;
+		ant = novo;
+		if (!RegistaVerticeIndice(g, novo)) DesativaAntecessores(g);
+	}
+
+	free(ids);
+	return ok;
+}
+
+
+/**
+ * @brief Insere um conjunto de arestas no grafo de uma s vez.
+ *
+ * Equivalente a chamar InsereAdjacenciasGrafo para cada aresta, pela ordem do vetor, mas em
+ * tempo linear: os vrtices em falta so criados numa nica passagem pela lista de vrtices
+ * e a cauda da lista de adjacncias de cada origem  procurada uma s vez, sendo as arestas
+ * seguintes acrescentadas diretamente a seguir  ltima inserida.
+ *
+ * @param g Um apontador para o grafo.
+ * @param arestas Vetor de arestas (origem, destino, peso).
+ * @param numArestas Nmero de arestas do vetor.
+ * @param criaVertices true para criar os vrtices que no existam; false para ignorar as arestas
+ *                     cuja origem ou destino no existam, como InsereAdjacenciasGrafo.
+ * @param numInseridas Apontador para o nmero de arestas inseridas (pode ser NULL).
+ * @return Um apontador para o grafo.
+ */
+Grafo* InsereArestasGrafo(Grafo* g, const ArestaGrafo* arestas, int numArestas, bool criaVertices, int* numInseridas) {
+	if (numInseridas != NULL) *numInseridas = 0;
+	if (g == NULL || arestas == NULL || numArestas <= 0) return g;
+
+	if (criaVertices && !CriaVerticesEmFalta(g, arestas, numArestas)) return g;
+
+	// Na representao densa cada insero j  feita em tempo constante
+	if (g->densa != NULL) {
+		int inseridas = 0;
+		for (int i = 0; i < numArestas; i++) {
+			bool ok;
+			InsereAdjacenciasGrafo(g, arestas[i].origem, arestas[i].destino, arestas[i].peso, &ok);
+			if (ok) inseridas++;
+			if (g->densa == NULL) {
+				// Passou a listas: o resto segue pelo caminho normal
+				int resto;
+				InsereArestasGrafo(g, arestas + i + 1, numArestas - i - 1, false, &resto);
+				inseridas += resto;
+				break;
+			}
+		}
+		if (numInseridas != NULL) *numInseridas = inseridas;
+		return g;
+	}
+
+	// Cauda da lista de adjacncias de cada origem indexada, encontrada na primeira utilizao
+	int maiorOrigem = -1;
+	for (int i = 0; i < numArestas; i++) {
+		if (arestas[i].origem >= 0 && arestas[i].origem < g->tamanhoIndice && arestas[i].origem > maiorOrigem) {
+			maiorOrigem = arestas[i].origem;
+		}
+	}
+	Adjacencias** caudas = (Adjacencias**)calloc((size_t)maiorOrigem + 1, sizeof(Adjacencias*));
+	if (caudas == NULL) return g;
+
+	int inseridas = 0;
+	for (int i = 0; i < numArestas; i++) {
+		Vertices* origemV = OndeEstaVerticeGrafo(g, arestas[i].origem);
+		if (origemV == NULL || !ExisteVerticeGrafo(g, arestas[i].destino)) continue;
+
+		Adjacencias* nova = NovaAdjacenciaArena(g, arestas[i].destino, arestas[i].peso);
+		if (nova == NULL) break;
+		if (!RegistaAlteracao(g, DIARIO_INSERE_ADJ, arestas[i].origem, arestas[i].destino, arestas[i].peso)) {
+			LibertaAdjacenciaArena(g, nova);
+			break;
+		}
+
+		bool indexada = (arestas[i].origem >= 0 && arestas[i].origem <= maiorOrigem);
+		Adjacencias* cauda = indexada ? caudas[arestas[i].origem] : NULL;
+		if (cauda == NULL) {
+			cauda = origemV->proxAdj;
+			while (cauda != NULL && cauda->next != NULL) {
+				cauda = cauda->next;
+			}
+		}
+		if (cauda == NULL) origemV->proxAdj = nova;
+		else cauda->next = nova;
+		if (indexada) caudas[arestas[i].origem] = nova;
+		if (g->antecessores != NULL) AcrescentaAntecessor(g, arestas[i].destino, arestas[i].origem, arestas[i].peso);
+		TabelaAcrescentaAresta(g, arestas[i].origem, nova);
+		inseridas++;
+	}
+
+	free(caudas);
+	if (numInseridas != NULL) *numInseridas = inseridas;
+	return g;
+}
+
+
+/**
+ * @brief Mostra na sada padro a representao do grafo.
+ *
+ * Esta funo mostra na sada padro a representao do grafo, exibindo os vrtices
+ * e suas adjacncias, juntamente com os pesos das adjacncias.
+ *
+ * @param grafo Um apontador para o primeiro vrtice do grafo.
+ */
+void MostrarGrafo(Vertices* grafo) {
+	Vertices* atual = grafo;
+	while (atual != NULL) {
+		printf("vertice:%d \n", atual->id);
+		Adjacencias* AdjacenciaAtual = atual->proxAdj;
+		while (AdjacenciaAtual != NULL)
+		{
+			printf("\tadjacente com:%d com peso de:%d \n", AdjacenciaAtual->id, AdjacenciaAtual->peso);
+			AdjacenciaAtual = AdjacenciaAtual->next;
+		}
+		atual = atual->proxVertice;
+		printf("\n");
+	}
+}
+
+
+/**
+ * @brief Mostra na sada padro a representao do grafo, em qualquer das representaes.
+ *
+ * Com listas  equivalente a MostrarGrafo(g->inicioGrafo); na representao densa, as
+ * adjacncias de cada vrtice so lidas da linha da matriz, pela ordem das colunas.
+ *
+ * @param g Um apontador para o grafo.
+ */
+void ImprimeGrafo(Grafo* g) {
+	if (g == NULL) return;
+	if (g->densa == NULL) {
+		MostrarGrafo(g->inicioGrafo);
+		return;
+	}
+
+	bool* visitado = (bool*)calloc((size_t)g->densa->numVertices + 1, sizeof(bool));
+	if (visitado == NULL) return;
+	for (Vertices* atual = g->inicioGrafo; atual != NULL; atual = atual->proxVertice) {
+		printf("vertice:%d \n", atual->id);
+		QuadroDFS quadro;
+		int destino, peso;
+		IniciaQuadro(g, atual->id, 0, &quadro);
+		while (ProximaAdjacencia(g, &quadro, visitado, &destino, &peso)) {
+			printf("\tadjacente com:%d com peso de:%d \n", destino, peso);
+		}
+		printf("\n");
+	}
+	free(visitado);
+}
+
+
+
+#pragma endregion
+
+
+/**
+ * @brief Carrega uma matriz de um ficheiro e a converte em um grafo.
+ *
+ * Esta funo l uma matriz de um ficheiro delimitado por ponto e vrgula,
+ * cria um grafo a partir dos dados da matriz, onde cada clula no-nula
+ * representa uma aresta com peso entre dois vrtices.Se a clula for nula
+ * a aresta no ser implementada.
+ *
+ * O ficheiro  mapeado em memria e analisado diretamente, sem limite para o comprimento
+ * das linhas (ver ConstroiGrafoMatriz). Ficheiros com pelo menos LIMIARCARGAPARALELA bytes
+ * so analisados com todos os processadores.
+ *
+ * @param fileName O nome do ficheiro que contem a matriz.
+ * @param numLinhas Um apontador para um inteiro onde o nmero de linhas da matriz ser armazenado.
+ * @param numColunas Um apontador para um inteiro onde o nmero de colunas da matriz ser armazenado.
+ *
+ * @return Um apontador para o grafo criado a partir da matriz, ou NULL em caso de erro.
+ *
+ */
+Grafo* carregarMatrizParaGrafo(char fileName[], int* numLinhas, int* numColunas) {
+	FicheiroMapeado mapa;
+
+	*numLinhas = 0;
+	*numColunas = 0;
+
+	if (!MapeiaFicheiro(fileName, &mapa)) {
+		return NULL;
+	}
+
+	int numFios = (mapa.tamanho >= LIMIARCARGAPARALELA) ? 0 : 1;
+	Grafo* grafo = ConstroiGrafoMatrizParalelo(mapa.dados, mapa.tamanho, numLinhas, numColunas, numFios);
+
+	DesmapeiaFicheiro(&mapa);
+	return grafo;
+}
+
+
+/**
+ * @brief Carrega uma matriz de um ficheiro para um grafo, analisando as linhas em paralelo.
+ *
+ * @param fileName O nome do ficheiro que contem a matriz.
+ * @param numLinhas Um apontador para um inteiro onde o nmero de linhas da matriz ser armazenado.
+ * @param numColunas Um apontador para um inteiro onde o nmero de colunas da matriz ser armazenado.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @return Um apontador para o grafo criado a partir da matriz, ou NULL em caso de erro.
+ */
+Grafo* carregarMatrizParaGrafoParalelo(char fileName[], int* numLinhas, int* numColunas, int numFios) {
+	FicheiroMapeado mapa;
+
+	*numLinhas = 0;
+	*numColunas = 0;
+
+	if (!MapeiaFicheiro(fileName, &mapa)) {
+		return NULL;
+	}
+
+	Grafo* grafo = ConstroiGrafoMatrizParalelo(mapa.dados, mapa.tamanho, numLinhas, numColunas, numFios);
+
+	DesmapeiaFicheiro(&mapa);
+	return grafo;
+}
+
+
+/**
+ * @brief Mapeia um ficheiro em memria s de leitura.
+ *
+ * Um ficheiro vazio  aceite e fica com dados a NULL e tamanho 0.
+ *
+ * @param fileName O nome do ficheiro a mapear.
+ * @param mapa Apontador para a estrutura que recebe o mapeamento.
+ * @return true se o ficheiro foi mapeado, false caso contrrio.
+ */
+bool MapeiaFicheiro(char fileName[], FicheiroMapeado* mapa) {
+	mapa->dados = NULL;
+	mapa->tamanho = 0;
+	mapa->ficheiro = NULL;
+	mapa->mapeamento = NULL;
+	if (fileName == NULL) return false;
+
+#ifdef _WIN32
+	HANDLE ficheiro = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (ficheiro == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER tamanho;
+	if (!GetFileSizeEx(ficheiro, &tamanho)) {
+		CloseHandle(ficheiro);
+		return false;
+	}
+	if (tamanho.QuadPart == 0) {
+		CloseHandle(ficheiro);
+		return true;
+	}
+	HANDLE mapeamento = CreateFileMappingA(ficheiro, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapeamento == NULL) {
+		CloseHandle(ficheiro);
+		return false;
+	}
+	const char* dados = (const char*)MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0);
+	if (dados == NULL) {
+		CloseHandle(mapeamento);
+		CloseHandle(ficheiro);
+		return false;
+	}
+	mapa->dados = dados;
+	mapa->tamanho = (size_t)tamanho.QuadPart;
+	mapa->ficheiro = ficheiro;
+	mapa->mapeamento = mapeamento;
+#else
+	int fd = open(fileName, O_RDONLY);
+	if (fd < 0) return false;
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		return false;
+	}
+	if (info.st_size == 0) {
+		close(fd);
+		return true;
+	}
+	void* dados = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // o mapeamento mantm-se vlido depois de fechar o descritor
+	if (dados == MAP_FAILED) return false;
+	madvise(dados, (size_t)info.st_size, MADV_SEQUENTIAL);
+	mapa->dados = (const char*)dados;
+	mapa->tamanho = (size_t)info.st_size;
+#endif
+	return true;
+}
+
+
+/**
+ * @brief Desfaz um mapeamento criado por MapeiaFicheiro.
+ *
+ * @param mapa Apontador para o mapeamento.
+ */
+void DesmapeiaFicheiro(FicheiroMapeado* mapa) {
+	if (mapa == NULL) return;
+#ifdef _WIN32
+	if (mapa->dados != NULL) UnmapViewOfFile(mapa->dados);
+	if (mapa->mapeamento != NULL) CloseHandle((HANDLE)mapa->mapeamento);
+	if (mapa->ficheiro != NULL) CloseHandle((HANDLE)mapa->ficheiro);
+#else
+	if (mapa->dados != NULL) munmap((void*)mapa->dados, mapa->tamanho);
+#endif
+	mapa->dados = NULL;
+	mapa->tamanho = 0;
+	mapa->ficheiro = NULL;
+	mapa->mapeamento = NULL;
+}
+
+
+/**
+ * @brief Procura o prximo separador de campo (';') ou de linha ('\n').
+ *
+ * Com SSE2 compara 16 bytes de cada vez e usa a mscara das comparaes para saltar
+ * diretamente para o separador; os ltimos bytes do ficheiro so lidos um a um.
+ *
+ * @param p Posio onde comea a procura.
+ * @param fim Fim dos dados.
+ * @return A posio do separador, ou fim se no houver mais nenhum.
+ */
+static const char* ProcuraSeparador(const char* p, const char* fim) {
+#ifdef USA_SSE2
+	const __m128i pontoVirgula = _mm_set1_epi8(';');
+	const __m128i mudaLinha = _mm_set1_epi8('\n');
+	while (fim - p >= 16) {
+		__m128i bloco = _mm_loadu_si128((const __m128i*)p);
+		int mascara = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bloco, pontoVirgula), _mm_cmpeq_epi8(bloco, mudaLinha)));
+		if (mascara != 0) {
+			return p + BitMenosSignificativo((unsigned int)mascara);
+		}
+		p += 16;
+	}
+#endif
+	while (p < fim && *p != ';' && *p != '\n') {
+		p++;
+	}
+	return p;
+}
+
+
+/**
+ * @brief Converte um campo da matriz num inteiro, como atoi, sem sair dos limites do campo.
+ *
+ * Ignora espaos iniciais, aceita um sinal e l os dgitos at ao primeiro carcter que no
+ * seja dgito. Um campo vazio ou sem dgitos vale 0.
+ *
+ * @param p Incio do campo.
+ * @param fim Fim do campo (exclusivo).
+ * @return O valor do campo.
+ */
+static int ConverteCampo(const char* p, const char* fim) {
+	while (p < fim && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+	bool negativo = false;
+	if (p < fim && (*p == '-' || *p == '+')) {
+		negativo = (*p == '-');
+		p++;
+	}
+	unsigned int valor = 0;
+	while (p < fim && (unsigned)(*p - '0') < 10u) {
+		valor = valor * 10u + (unsigned)(*p - '0');
+		p++;
+	}
+	return negativo ? (int)(0u - valor) : (int)valor;
+}
+
+
+/*
+ * Parte de uma matriz analisada por um fio: um intervalo de linhas completas do texto.
+ * As adjacncias so reservadas numa arena local e encadeadas por linha; no fim, os
+ * blocos da arena passam para o grafo (ou so libertados, se o grafo ficar denso).
+ */
+typedef struct ParteMatriz {
+	const char* inicio;
+	const char* fim;
+	ArenaGrafo arena;
+	ArenaGrafo arenaVertices;	//vrtices criados na fuso
+	Adjacencias** cabecas;		//primeira adjacncia de cada linha local
+	long long numArestas;
+	int numLinhas;
+	int capacidadeLinhas;
+	bool* colunas;				//colunas com clulas no nulas nesta parte
+	int capacidadeColunas;
+	int maiorColuna;
+	int numColunas;				//maior nmero de colunas de uma linha
+	bool erro;
+	// Fuso: intervalo de ids cujos vrtices este fio cria
+	Grafo* grafo;
+	struct ParteMatriz* partes;
+	int numPartes;
+	int linhaBase;				//id da primeira linha desta parte
+	int idInicio;
+	int idFim;
+	Vertices* primeiro;
+	Vertices* ultimo;
+}ParteMatriz;
+
+
+/**
+ * @brief Analisa as linhas de uma parte da matriz (fase paralela da carga).
+ */
+static void AnalisaParteMatriz(void* contexto) {
+	ParteMatriz* parte = (ParteMatriz*)contexto;
+	const char* p = parte->inicio;
+	const char* fim = parte->fim;
+
+	while (p < fim && !parte->erro) {
+		if (parte->numLinhas == parte->capacidadeLinhas) {
+			int nova = (parte->capacidadeLinhas == 0) ? 1024 : 2 * parte->capacidadeLinhas;
+			Adjacencias** maior = (Adjacencias**)realloc(parte->cabecas, nova * sizeof(Adjacencias*));
+			if (maior == NULL) {
+				parte->erro = true;
+				break;
+			}
+			parte->cabecas = maior;
+			parte->capacidadeLinhas = nova;
+		}
+		Adjacencias** cabeca = &parte->cabecas[parte->numLinhas];
+		*cabeca = NULL;
+		Adjacencias* cauda = NULL;
+
+		// Percorre os campos da linha at ao fim de linha
+		int coluna = 0;
+		while (true) {
+			const char* sep = ProcuraSeparador(p, fim);
+			int valor = ConverteCampo(p, sep);
+			if (valor != 0) {
+				if (coluna >= parte->capacidadeColunas) {
+					int nova = (parte->capacidadeColunas == 0) ? 1024 : parte->capacidadeColunas;
+					while (nova <= coluna) nova *= 2;
+					bool* aux = (bool*)realloc(parte->colunas, nova * sizeof(bool));
+					if (aux == NULL) {
+						parte->erro = true;
+						break;
+					}
+					memset(aux + parte->capacidadeColunas, 0, (nova - parte->capacidadeColunas) * sizeof(bool));
+					parte->colunas = aux;
+					parte->capacidadeColunas = nova;
+				}
+				Adjacencias* nova = (Adjacencias*)ReservaArena(&parte->arena, sizeof(Adjacencias));
+				if (nova == NULL) {
+					parte->erro = true;
+					break;
+				}
+				nova->id = coluna;
+				nova->peso = valor;
+				nova->daArena = true;
+				nova->next = NULL;
+				if (cauda == NULL) *cabeca = nova;
+				else cauda->next = nova;
+				cauda = nova;
+				parte->colunas[coluna] = true;
+				parte->numArestas++;
+				if (coluna > parte->maiorColuna) parte->maiorColuna = coluna;
+			}
+			coluna++;
+			if (sep >= fim) {
+				p = fim;
+				break;
+			}
+			p = sep + 1;
+			if (*sep == '\n') break;
+		}
+		if (coluna > parte->numColunas) parte->numColunas = coluna;
+		parte->numLinhas++;
+	}
+}
+
+
+/**
+ * @brief Cria os vrtices de um intervalo de ids e liga-lhes as listas de adjacncias (fase de fuso).
+ *
+ * Se o grafo for denso, as listas so copiadas para as linhas da matriz, que so disjuntas
+ * entre fios.
+ */
+static void FundeParteMatriz(void* contexto) {
+	ParteMatriz* parte = (ParteMatriz*)contexto;
+	Grafo* grafo = parte->grafo;
+	MatrizDensa* densa = grafo->densa;
+
+	int k = 0; // parte que contm a linha atual
+	for (int id = parte->idInicio; id < parte->idFim; id++) {
+		while (k < parte->numPartes - 1 && id >= parte->partes[k].linhaBase + parte->partes[k].numLinhas) {
+			k++;
+		}
+		ParteMatriz* dona = &parte->partes[k];
+		Adjacencias* cabeca = NULL;
+		if (id >= dona->linhaBase && id < dona->linhaBase + dona->numLinhas) {
+			cabeca = dona->cabecas[id - dona->linhaBase];
+		}
+
+		bool existe = (cabeca != NULL);
+		for (int t = 0; t < parte->numPartes && !existe; t++) {
+			existe = (id < parte->partes[t].capacidadeColunas && parte->partes[t].colunas[id]);
+		}
+		if (!existe) continue;
+
+		Vertices* v = (Vertices*)ReservaArena(&parte->arenaVertices, sizeof(Vertices));
+		if (v == NULL) {
+			parte->erro = true;
+			return;
+		}
+		if (densa != NULL) {
+			for (Adjacencias* adj = cabeca; adj != NULL; adj = adj->next) {
+				MarcaArestaDensa(densa, id, adj->id, adj->peso);
+			}
+			cabeca = NULL;
+		}
+		v->id = id;
+		v->daArena = true;
+		v->proxAdj = cabeca;
+		v->proxVertice = NULL;
+		if (parte->ultimo == NULL) parte->primeiro = v;
+		else parte->ultimo->proxVertice = v;
+		parte->ultimo = v;
+	}
+}
+
+
+/**
+ * @brief Constri um grafo a partir do texto de uma matriz separada por ponto e vrgula.
+ *
+ * Cada linha da matriz  um vrtice de origem e cada clula no nula da coluna j uma aresta
+ * para o vrtice j. As adjacncias de cada linha so encadeadas  medida que so lidas, por
+ * ordem das colunas, e os vrtices so criados no fim de uma s vez, j ordenados, em vez de
+ * inserir cada clula com InsereAdjacenciasGrafo. As linhas podem ter qualquer comprimento e
+ * uma clula vazia vale 0.
+ *
+ * @param dados O texto da matriz (no precisa de terminar em '\0').
+ * @param tamanho O nmero de bytes do texto.
+ * @param numLinhas Um apontador para o nmero de linhas da matriz.
+ * @param numColunas Um apontador para o maior nmero de colunas de uma linha.
+ * @return Um apontador para o grafo criado, ou NULL em caso de erro.
+ */
+Grafo* ConstroiGrafoMatriz(const char* dados, size_t tamanho, int* numLinhas, int* numColunas) {
+	return ConstroiGrafoMatrizParalelo(dados, tamanho, numLinhas, numColunas, 1);
+}
+
+
+/**
+ * @brief Constri um grafo a partir do texto de uma matriz, repartindo as linhas por vrios fios.
+ *
+ * O texto  dividido em intervalos que comeam e acabam em fins de linha, um por fio. Cada fio
+ * analisa as suas linhas para uma arena local, sem partilhar estado com os outros. Na fuso,
+ * cada fio cria os vrtices de um intervalo de ids e liga-lhes as listas de adjacncias j
+ * construdas; por fim, os intervalos e os blocos das arenas locais so encadeados no grafo.
+ * O grafo resultante  igual ao de ConstroiGrafoMatriz.
+ *
+ * Se pelo menos DENSIDADEMATRIZ por cento das clulas forem no nulas, o grafo fica na
+ * representao densa (ver ConverteGrafoDenso): as arestas so copiadas para a matriz de
+ * pesos em vez de ficarem nas listas. Se a matriz no couber em memria, usa listas.
+ *
+ * @param dados O texto da matriz (no precisa de terminar em '\0').
+ * @param tamanho O nmero de bytes do texto.
+ * @param numLinhas Um apontador para o nmero de linhas da matriz.
+ * @param numColunas Um apontador para o maior nmero de colunas de uma linha.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @return Um apontador para o grafo criado, ou NULL em caso de erro.
+ */
+Grafo* ConstroiGrafoMatrizParalelo(const char* dados, size_t tamanho, int* numLinhas, int* numColunas, int numFios) {
+	*numLinhas = 0;
+	*numColunas = 0;
+
+	Grafo* grafo = CriaGrafo();
+	if (grafo == NULL) return NULL;
+	if (dados == NULL || tamanho == 0) return grafo;
+
+	if (numFios <= 0) numFios = NumeroProcessadores();
+	if ((size_t)numFios > tamanho / 4096 + 1) numFios = (int)(tamanho / 4096 + 1); // partes pequenas no compensam
+
+	ParteMatriz* partes = (ParteMatriz*)calloc(numFios, sizeof(ParteMatriz));
+	if (partes == NULL) {
+		DestroiGrafo(grafo);
+		return NULL;
+	}
+
+	// Divide o texto em intervalos que terminam logo aps um '\n'
+	const char* fim = dados + tamanho;
+	const char* inicio = dados;
+	for (int t = 0; t < numFios; t++) {
+		const char* corte = (t == numFios - 1) ? fim : dados + tamanho / numFios * (t + 1);
+		if (corte < inicio) corte = inicio;
+		while (corte < fim && corte > dados && corte[-1] != '\n') {
+			corte++;
+		}
+		partes[t].inicio = inicio;
+		partes[t].fim = corte;
+		partes[t].maiorColuna = -1;
+		inicio = corte;
+	}
+
+	ExecutaEmParalelo(numFios, AnalisaParteMatriz, partes, sizeof(ParteMatriz));
+
+	bool erro = false;
+	int linhas = 0;
+	int numIds = 0;
+	long long numArestas = 0;
+	for (int t = 0; t < numFios; t++) {
+		erro = erro || partes[t].erro;
+		numArestas += partes[t].numArestas;
+		partes[t].linhaBase = linhas;
+		linhas += partes[t].numLinhas;
+		if (partes[t].numColunas > *numColunas) *numColunas = partes[t].numColunas;
+		if (partes[t].maiorColuna + 1 > numIds) numIds = partes[t].maiorColuna + 1;
+	}
+	*numLinhas = linhas;
+	if (linhas > numIds) numIds = linhas;
+
+	// Fuso: cada fio cria os vrtices de um intervalo de ids
+	if (!erro && numIds > 0) {
+		erro = !AumentaIndiceVertices(grafo, numIds - 1, numIds);
+	}
+	if (!erro && numIds > 0 && numArestas * 100 / numIds >= (long long)DENSIDADEMATRIZ * numIds) {
+		grafo->densa = CriaMatrizDensa(numIds); // NULL se no houver memria: fica com listas
+	}
+	if (!erro) {
+		for (int t = 0; t < numFios; t++) {
+			partes[t].grafo = grafo;
+			partes[t].partes = partes;
+			partes[t].numPartes = numFios;
+			partes[t].idInicio = (int)((long long)numIds * t / numFios);
+			partes[t].idFim = (int)((long long)numIds * (t + 1) / numFios);
+		}
+		ExecutaEmParalelo(numFios, FundeParteMatriz, partes, sizeof(ParteMatriz));
+	}
+
+	// Encadeia os intervalos de vrtices e passa os blocos das arenas locais para o grafo
+	Vertices* ultimo = NULL;
+	for (int t = 0; t < numFios; t++) {
+		erro = erro || partes[t].erro;
+		if (!erro && partes[t].primeiro != NULL) {
+			if (ultimo == NULL) grafo->inicioGrafo = partes[t].primeiro;
+			else ultimo->proxVertice = partes[t].primeiro;
+			ultimo = partes[t].ultimo;
+		}
+
+		if (grafo->densa != NULL) {
+			DestroiArena(&partes[t].arena); // as listas j foram copiadas para a matriz
+		}
+		ArenaGrafo* locais[2] = { &partes[t].arena, &partes[t].arenaVertices };
+		for (int a = 0; a < 2; a++) {
+			BlocoArena* bloco = locais[a]->blocos;
+			while (bloco != NULL) {
+				BlocoArena* prox = bloco->proximo;
+				bloco->proximo = grafo->arena.blocos;
+				grafo->arena.blocos = bloco;
+				bloco = prox;
+			}
+		}
+		free(partes[t].cabecas);
+		free(partes[t].colunas);
+	}
+	free(partes);
+
+	if (erro) {
+		DestroiGrafo(grafo);
+		return NULL;
+	}
+	// A tabela j tem lugar para todos os ids: o registo  feito aqui, fora dos fios
+	for (Vertices* v = grafo->inicioGrafo; v != NULL; v = v->proxVertice) {
+		RegistaVerticeIndice(grafo, v);
+	}
+	return grafo;
+}
+
+
+/*
+ * Escrita com buffer prprio, de tamanho fixo, usada pela carga em streaming.
+ */
+typedef struct EscritorBloco {
+	FILE* fp;
+	char* buffer;
+	size_t capacidade;
+	size_t usados;
+	bool erro;
+}EscritorBloco;
+
+
+static void DescarregaBloco(EscritorBloco* e) {
+	if (e->usados > 0 && !e->erro) {
+		if (fwrite(e->buffer, 1, e->usados, e->fp) != e->usados) e->erro = true;
+	}
+	e->usados = 0;
+}
+
+
+static void EscreveInteiroBloco(EscritorBloco* e, int valor) {
+	if (e->usados + sizeof(int) > e->capacidade) DescarregaBloco(e);
+	memcpy(e->buffer + e->usados, &valor, sizeof(int));
+	e->usados += sizeof(int);
+}
+
+
+/**
+ * @brief Acrescenta a um ficheiro o contedo de outro, em blocos do buffer dado.
+ */
+static bool CopiaFicheiro(FILE* destino, FILE* origem, char* buffer, size_t capacidade) {
+	rewind(origem);
+	size_t lidos;
+	while ((lidos = fread(buffer, 1, capacidade, origem)) > 0) {
+		if (fwrite(buffer, 1, lidos, destino) != lidos) return false;
+	}
+	return !ferror(origem);
+}
+
+
+/**
+ * @brief Converte uma matriz num ficheiro CSR sem construir o grafo em memria.
+ *
+ * A matriz  lida em blocos de tamanho fixo e cada clula no nula  escrita diretamente no
+ * ficheiro CSR (os destinos) ou em ficheiros temporrios (pesos e offsets), que no fim so
+ * acrescentados ao ficheiro CSR. As linhas da matriz so os vrtices de origem, por ordem, pelo
+ * que os offsets saem j ordenados. Tal como em carregarMatrizParaGrafo, existem todos os
+ * vrtices de 0 at ao maior ndice de linha ou de coluna com valor. A memria usada fica
+ * limitada ao oramento indicado, independentemente do tamanho da matriz. O ficheiro
+ * resultante segue o formato descrito por CabecalhoGrafoCSR e tem o mesmo contedo que
+ * CongelaGrafo produziria para a mesma matriz.
+ *
+ * @param ficheiroMatriz O nome do ficheiro que contem a matriz.
+ * @param ficheiroCSR O nome do ficheiro CSR a criar.
+ * @param orcamento Memria mxima, em bytes, para os buffers de leitura e escrita (mnimo MINIMOORCAMENTO).
+ * @param progresso Funo chamada aps cada bloco lido (pode ser NULL).
+ * @param contexto Apontador passado  funo de progresso.
+ * @param numLinhas Um apontador para o nmero de linhas da matriz.
+ * @param numColunas Um apontador para o maior nmero de colunas de uma linha.
+ * @return true se o ficheiro CSR foi criado, false em caso de erro.
+ */
+bool ConverteMatrizParaCSR(char ficheiroMatriz[], char ficheiroCSR[], size_t orcamento, ProgressoCarga progresso, void* contexto, int* numLinhas, int* numColunas) {
+	*numLinhas = 0;
+	*numColunas = 0;
+	if (ficheiroMatriz == NULL || ficheiroCSR == NULL) return false;
+	if (orcamento < MINIMOORCAMENTO) orcamento = MINIMOORCAMENTO;
+
+	// Metade do oramento para leitura, o resto repartido pelas trs escritas
+	size_t capLeitura = orcamento / 2;
+	size_t capEscrita = (orcamento - capLeitura) / 3;
+	capEscrita -= capEscrita % sizeof(int);
+
+	size_t tamNome = strlen(ficheiroCSR);
+	char* nomePesos = (char*)malloc(tamNome + 16);
+	char* nomeOffsets = (char*)malloc(tamNome + 16);
+	char* memoria = (char*)malloc(orcamento);
+	if (nomePesos == NULL || nomeOffsets == NULL || memoria == NULL) {
+		free(nomePesos);
+		free(nomeOffsets);
+		free(memoria);
+		return false;
+	}
+	sprintf(nomePesos, "%s.pesos.tmp", ficheiroCSR);
+	sprintf(nomeOffsets, "%s.offsets.tmp", ficheiroCSR);
+
+	FILE* entrada = fopen(ficheiroMatriz, "rb");
+	EscritorBloco destinos = { fopen(ficheiroCSR, "wb"), memoria + capLeitura, capEscrita, 0, false };
+	EscritorBloco pesos = { fopen(nomePesos, "w+b"), memoria + capLeitura + capEscrita, capEscrita, 0, false };
+	EscritorBloco offsets = { fopen(nomeOffsets, "w+b"), memoria + capLeitura + 2 * capEscrita, capEscrita, 0, false };
+	bool ok = (entrada != NULL && destinos.fp != NULL && pesos.fp != NULL && offsets.fp != NULL);
+
+	long long totalBytes = 0;
+	if (ok) {
+#ifdef _WIN32
+		_fseeki64(entrada, 0, SEEK_END);
+		totalBytes = _ftelli64(entrada);
+#else
+		fseeko(entrada, 0, SEEK_END);
+		totalBytes = (long long)ftello(entrada);
+#endif
+		rewind(entrada);
+	}
+
+	// Reserva o espao do cabealho, escrito no fim
+	CabecalhoGrafoCSR cab;
+	memset(&cab, 0, sizeof(cab));
+	if (ok && fwrite(&cab, sizeof(cab), 1, destinos.fp) != 1) ok = false;
+
+	char* leitura = memoria;
+	size_t pendente = 0;		// bytes do campo incompleto no incio do buffer
+	long long bytesLidos = 0;
+	long long numArestas = 0;
+	int linha = 0;
+	int coluna = 0;
+	int maiorId = -1;
+	if (ok) EscreveInteiroBloco(&offsets, 0);
+
+	while (ok) {
+		size_t lidos = fread(leitura + pendente, 1, capLeitura - pendente, entrada);
+		bool fimFicheiro = (lidos == 0);
+		bytesLidos += (long long)lidos;
+		const char* p = leitura;
+		const char* fim = leitura + pendente + lidos;
+
+		while (p < fim) {
+			const char* sep = ProcuraSeparador(p, fim);
+			if (sep >= fim && !fimFicheiro) break; // campo incompleto, continua no prximo bloco
+
+			int valor = ConverteCampo(p, sep);
+			if (valor != 0) {
+				EscreveInteiroBloco(&destinos, coluna);
+				EscreveInteiroBloco(&pesos, valor);
+				numArestas++;
+				if (linha > maiorId) maiorId = linha;
+				if (coluna > maiorId) maiorId = coluna;
+			}
+			coluna++;
+
+			if (sep >= fim || *sep == '\n') {
+				// Fim da linha: regista o offset do prximo vrtice
+				if (coluna > *numColunas) *numColunas = coluna;
+				linha++;
+				coluna = 0;
+				if (numArestas > INT_MAX) {
+					ok = false;
+					break;
+				}
+				EscreveInteiroBloco(&offsets, (int)numArestas);
+			}
+			p = (sep < fim) ? sep + 1 : fim;
+		}
+
+		if (fimFicheiro || !ok) break;
+
+		// Guarda o campo incompleto, inteiro, para o prximo bloco; um campo que ocupa
+		// todo o buffer de leitura no pode ser completado e a converso falha
+		pendente = (size_t)(fim - p);
+		if (pendente >= capLeitura) {
+			ok = false;
+			break;
+		}
+		memmove(leitura, p, pendente);
+		if (progresso != NULL) progresso(bytesLidos, totalBytes, contexto);
+	}
+	if (ok && ferror(entrada)) ok = false;
+
+	// Completa os offsets at numVertices + 1 entradas; todas as linhas so vrtices
+	cab.numVertices = (maiorId + 1 > linha) ? maiorId + 1 : linha;
+	cab.numIds = cab.numVertices;
+	for (int v = linha; ok && v < cab.numVertices; v++) {
+		EscreveInteiroBloco(&offsets, (int)numArestas);
+	}
+	DescarregaBloco(&destinos);
+	DescarregaBloco(&pesos);
+	DescarregaBloco(&offsets);
+	ok = ok && !destinos.erro && !pesos.erro && !offsets.erro;
+
+	// Junta pesos e offsets ao ficheiro CSR e escreve o cabealho final
+	if (ok) {
+		fflush(pesos.fp);
+		fflush(offsets.fp);
+		memcpy(cab.magia, "GCSR", 4);
+		cab.versao = VERSAOGRAFOCSR;
+		cab.numArestas = (int)numArestas;
+		cab.posDestinos = (long long)sizeof(cab);
+		cab.posPesos = cab.posDestinos + numArestas * (long long)sizeof(int);
+		cab.posInicioAdj = cab.posPesos + numArestas * (long long)sizeof(int);
+		cab.posIds = cab.posInicioAdj + ((long long)cab.numVertices + 1) * (long long)sizeof(int);
+		ok = CopiaFicheiro(destinos.fp, pesos.fp, memoria, orcamento);
+		if (ok) {
+			rewind(offsets.fp);
+			long long restantes = ((long long)cab.numVertices + 1) * (long long)sizeof(int);
+			while (ok && restantes > 0) {
+				size_t bloco = (restantes < (long long)orcamento) ? (size_t)restantes : orcamento;
+				if (fread(memoria, 1, bloco, offsets.fp) != bloco || fwrite(memoria, 1, bloco, destinos.fp) != bloco) ok = false;
+				restantes -= (long long)bloco;
+			}
+		}
+		if (ok) {
+			// Os ids so 0 a numVertices - 1; o buffer de escrita dos destinos est livre
+			for (int v = 0; v < cab.numVertices; v++) {
+				EscreveInteiroBloco(&destinos, v);
+			}
+			DescarregaBloco(&destinos);
+			ok = !destinos.erro;
+		}
+		if (ok) {
+			fseek(destinos.fp, 0, SEEK_SET);
+			ok = (fwrite(&cab, sizeof(cab), 1, destinos.fp) == 1);
+		}
+		if (ok && progresso != NULL) progresso(bytesLidos, totalBytes, contexto);
+	}
+
+	if (entrada != NULL) fclose(entrada);
+	if (destinos.fp != NULL && fclose(destinos.fp) != 0) ok = false;
+	if (pesos.fp != NULL) fclose(pesos.fp);
+	if (offsets.fp != NULL) fclose(offsets.fp);
+	remove(nomePesos);
+	remove(nomeOffsets);
+	if (!ok) remove(ficheiroCSR);
+
+	*numLinhas = linha;
+	free(nomePesos);
+	free(nomeOffsets);
+	free(memoria);
+	return ok;
+}
+
+
+/**
+ * @brief Guarda a estrutura de um grafo em um ficheiro binrio.
+ *
+ * O grafo  congelado em CSR e escrito no formato versionado descrito por CabecalhoGrafoCSR
+ * (ver GuardaGrafoCSR), que pode depois ser aberto com MapeiaGrafoCSR sem ser lido. O formato
+ * guarda todos os vrtices, incluindo os que no tm arestas. Os ids negativos no podem ser
+ * representados: um grafo com algum vrtice ou adjacncia de id negativo  rejeitado, sem
+ * criar o ficheiro.
+ *
+ * @param grafo Apontador para a estrutura do grafo que ser guardado.
+ * @param fileName Nome do ficheiro binrio onde o grafo ser guardado.
+ * @return true se o grafo foi salvo com sucesso, false caso contrrio (incluindo ids negativos).
+ *
+ */
+bool GuardaGrafoBinario(Grafo* grafo, char fileName[]) {
+	if (grafo == NULL || fileName == NULL) {
+		return false;
+	}
+
+	// Ids negativos: o formato no os suporta
+	for (Vertices* v = grafo->inicioGrafo; v != NULL; v = v->proxVertice) {
+		if (v->id < 0) return false;
+		for (Adjacencias* adj = v->proxAdj; adj != NULL; adj = adj->next) {
+			if (adj->id < 0) return false;
+		}
+	}
+
+	GrafoCSR* csr = CongelaGrafo(grafo);
+	if (csr == NULL) {
+		return false;
+	}
+
+	bool ok = GuardaGrafoCSR(csr, fileName);
+	DestroiGrafoCSR(csr);
+	return ok;
+}
+
+
+
+/**
+ * @brief Converte o formato binrio antigo, sem cabealho, num snapshot CSR.
+ *
+ * O formato antigo  uma sequncia de registos, um por vrtice: o id, o nmero de adjacncias
+ * e, para cada uma, o id de destino e o peso, tudo em int. Todos os registos so validados
+ * antes de serem usados; os ids tm de ser no negativos e no se podem repetir.
+ *
+ * @param dados Contedo do ficheiro.
+ * @param tamanho Tamanho do contedo em bytes.
+ * @return Um apontador para o snapshot CSR, ou NULL se o contedo for invlido ou a alocao falhar.
+ */
+static GrafoCSR* LeGrafoLegado(const char* dados, size_t tamanho) {
+	// Primeira passagem: valida os registos e conta vrtices e arestas
+	size_t numInts = tamanho / sizeof(int);
+	if (tamanho % sizeof(int) != 0) return NULL;
+	int numIds = 0;
+	long long numArestas = 0;
+	int maiorId = -1;
+	size_t pos = 0;
+	while (pos < numInts) {
+		int registo[2];
+		if (numInts - pos < 2) return NULL;
+		memcpy(registo, dados + pos * sizeof(int), sizeof(registo));
+		if (registo[0] < 0 || registo[0] == INT_MAX || registo[1] < 0 || (size_t)registo[1] > (numInts - pos - 2) / 2) return NULL;
+		if (registo[0] > maiorId) maiorId = registo[0];
+		for (int a = 0; a < registo[1]; a++) {
+			int destino;
+			memcpy(&destino, dados + (pos + 2 + 2 * (size_t)a) * sizeof(int), sizeof(int));
+			if (destino < 0 || destino == INT_MAX) return NULL;
+			if (destino > maiorId) maiorId = destino;
+		}
+		numIds++;
+		numArestas += registo[1];
+		pos += 2 + 2 * (size_t)registo[1];
+	}
+	if (numArestas > INT_MAX) return NULL;
+
+	GrafoCSR* csr = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+	if (csr == NULL) return NULL;
+	csr->ficheiro = NULL;
+	csr->offsetsAlocados = false;
+	csr->numVertices = maiorId + 1;
+	csr->numArestas = (int)numArestas;
+	csr->numIds = numIds;
+	csr->inicioAdj = (int*)calloc((size_t)csr->numVertices + 1, sizeof(int));
+	csr->destinos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->pesos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->ids = (int*)malloc(((size_t)numIds + 1) * sizeof(int));
+	if (csr->inicioAdj == NULL || csr->destinos == NULL || csr->pesos == NULL || csr->ids == NULL) {
+		DestroiGrafoCSR(csr);
+		return NULL;
+	}
+
+	// Segunda passagem: ids e graus; os registos podem vir por qualquer ordem
+	pos = 0;
+	for (int k = 0; k < numIds; k++) {
+		int registo[2];
+		memcpy(registo, dados + pos * sizeof(int), sizeof(registo));
+		csr->ids[k] = registo[0];
+		csr->inicioAdj[registo[0] + 1] = registo[1];
+		pos += 2 + 2 * (size_t)registo[1];
+	}
+	qsort(csr->ids, numIds, sizeof(int), ComparaInteiros);
+	for (int k = 1; k < numIds; k++) {
+		if (csr->ids[k] == csr->ids[k - 1]) {
+			DestroiGrafoCSR(csr);
+			return NULL;
+		}
+	}
+	for (int i = 0; i < csr->numVertices; i++) {
+		csr->inicioAdj[i + 1] += csr->inicioAdj[i];
+	}
+
+	// Terceira passagem: copia destinos e pesos pela ordem dos registos
+	pos = 0;
+	for (int k = 0; k < numIds; k++) {
+		int registo[2];
+		memcpy(registo, dados + pos * sizeof(int), sizeof(registo));
+		for (int a = 0; a < registo[1]; a++) {
+			int par[2];
+			memcpy(par, dados + (pos + 2 + 2 * (size_t)a) * sizeof(int), sizeof(par));
+			csr->destinos[csr->inicioAdj[registo[0]] + a] = par[0];
+			csr->pesos[csr->inicioAdj[registo[0]] + a] = par[1];
+		}
+		pos += 2 + 2 * (size_t)registo[1];
+	}
+	return csr;
+}
+
+
+/**
+ * @brief Carrega um grafo de um ficheiro binrio.
+ *
+ * Aceita o formato CSR (GuardaGrafoBinario), o compacto (GuardaGrafoBinarioCompacto) e o
+ * formato antigo, sem cabealho, em que cada vrtice  guardado como o id, o nmero de
+ * adjacncias e os pares (destino, peso). O ficheiro  validado e convertido num grafo
+ * altervel, com todos os vrtices guardados, incluindo os que no tm arestas.
+ *
+ * @param fileName O nome do ficheiro binrio de onde o grafo ser carregado.
+ * @return Um apontador para o grafo carregado, a destruir com DestroiGrafo, ou NULL se o
+ * ficheiro no existir ou for invlido.
+ */
+Grafo* CarregaGrafoBinario(char fileName[]) {
+	if (fileName == NULL) return NULL;
+
+	GrafoCSR* csr = MapeiaGrafoCSR(fileName);
+	if (csr == NULL) {
+		GrafoCompacto* gc = MapeiaGrafoCompacto(fileName);
+		if (gc != NULL) {
+			csr = DescomprimeGrafo(gc);
+			DestroiGrafoCompacto(gc);
+			if (csr == NULL) return NULL;
+		}
+	}
+	if (csr == NULL) {
+		FicheiroMapeado mapa;
+		if (!MapeiaFicheiro(fileName, &mapa)) return NULL;
+		csr = LeGrafoLegado(mapa.dados, mapa.tamanho);
+		DesmapeiaFicheiro(&mapa);
+		if (csr == NULL) return NULL;
+	}
+
+	Grafo* g = DescongelaGrafo(csr);
+	DestroiGrafoCSR(csr);
+	return g;
+}
+
+/**
+ * @brief Realiza uma procura em profundidade recursiva (DFS) num grafo.
+ *
+ * Esta funo percorre recursivamente o grafo a partir de um vrtice de origem,
+ * procurando todos os caminhos at um vrtice de destino. Durante a procura,
+ * os vrtices visitados so marcados, e os caminhos encontrados so armazenados
+ * e somados. Para no explorar ramos sem sada, o array visitado pode ser preparado com
+ * MarcaInalcancaveis.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitado Array de booleanos que indica se um vrtice foi visitado.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param indice ndice do prximo elemento no caminho.
+ * @param somaCaminhos Apontador para a varivel que acumula a soma dos caminhos.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* ProcuraProfundidadeRec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos) {
+	visitado[origem] = true;
+	caminho[indice] = origem; // Adiciona o vrtice atual ao caminho
+	indice++;
+
+	if (origem == destino) {
+		// Se o vrtice atual  o destino, imprime o caminho
+		for (int i = 0; i < indice; i++) {
+			printf("%d ", caminho[i]);
+		}
+		printf("\n");
+
+		// Calcula a soma dos valores dos vrtices no caminho
+		int soma = 0;
+		for (int i = 0; i < indice; i++) {
+			soma += caminho[i];
+		}
+		*somaCaminhos += soma;
+	}
+	else {
+		// Se o vrtice atual no  o destino, procura as adjacncias
+		QuadroDFS quadro;
+		int proximo, peso;
+		IniciaQuadro(g, origem, 0, &quadro);
+		while (ProximaAdjacencia(g, &quadro, visitado, &proximo, &peso)) {
+			ProcuraProfundidadeRec(g, proximo, destino, visitado, caminho, indice, somaCaminhos);
+		}
+	}
+
+	indice--;                 // Decrementa o ndice do caminho para backtracking
+	visitado[origem] = false; // Marca o vrtice atual como no visitado para permitir outros caminhos
+
+	return g;
+}
+
+
+/**
+ * @brief Realiza uma procura em profundidade (DFS) em um grafo e calcula a soma dos caminhos.
+ *
+ * Esta funo inicia a procura em profundidade a partir de um vrtice de origem,
+ * procurando todos os caminhos possveis at o vrtice de destino. Durante a procura,
+ * os vrtices visitados so marcados, e os caminhos encontrados so somados. Os vrtices
+ * que no podem chegar ao destino so excludos antes (ver MarcaInalcancaveis).
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param numVertices O nmero de vrtices no grafo.
+ * @param soma Apontador para a varivel que ir armazenar a soma dos valores dos vrtices nos caminhos encontrados.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* ProcuraProfundidade(Grafo* g, int origem, int destino, int numVertices, int* soma) {
+	*soma = 0;
+	bool* visitado = (bool*)malloc(numVertices * sizeof(bool)); 
+	int* caminho = (int*)malloc(numVertices * sizeof(int));     
+	QuadroDFS* pilha = (QuadroDFS*)malloc(numVertices * sizeof(QuadroDFS));
+	int somaCaminhos = 0;                                       
+	if (visitado == NULL || caminho == NULL || pilha == NULL) {
+		free(visitado);
+		free(caminho);
+		free(pilha);
+		return g;
+	}
+
+	for (int i = 0; i < numVertices; i++) {
+		visitado[i] = false; // Inicializa todos os vrtices como no visitados
+	}
+
+	// S entra em vrtices que podem chegar ao destino; sem caminho possvel, no h procura
+	if (MarcaInalcancaveis(g, origem, destino, visitado, numVertices)) {
+		ProcuraProfundidadeVisita(g, origem, destino, visitado, caminho, pilha, VisitanteMostraCaminho, &somaCaminhos, numVertices);
+	}
+
+	*soma = somaCaminhos;
+	free(visitado);
+	free(caminho);
+	free(pilha);
+	return g;
+}
+
+
+/**
+ * @brief Realiza uma procura em profundidade iterativa num grafo.
+ *
+ * Verso iterativa de ProcuraProfundidadeRec, com o mesmo resultado e a mesma ordem de sada.
+ * Em vez de uma chamada recursiva por vrtice do caminho, usa uma pilha explcita de quadros
+ * (vrtice, prxima adjacncia a explorar) num nico buffer, pelo que a profundidade do caminho
+ * s est limitada pela memria reservada pelo chamador.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitado Array de booleanos que indica se um vrtice foi visitado.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param pilha Buffer de quadros com uma posio por vrtice do grafo.
+ * @param somaCaminhos Apontador para a varivel que acumula a soma dos caminhos.
+ * @param numVertices Nmero de posies de visitado.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* ProcuraProfundidadeIter(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, int* somaCaminhos, int numVertices) {
+	return ProcuraProfundidadeVisita(g, origem, destino, visitado, caminho, pilha, VisitanteMostraCaminho, somaCaminhos, numVertices);
+}
+
+
+/**
+ * @brief Avana um quadro da procura densa at ao prximo vizinho ainda no visitado.
+ *
+ * Os vizinhos por visitar de cada palavra da linha so calculados de uma vez, como
+ * presenca & ~visitados, e percorridos com o ndice do bit menos significativo.
+ *
+ * @return true se encontrou um vizinho (destino e peso), false se o vrtice no tem mais.
+ */
+static bool ProximaAdjacenciaBits(MatrizDensa* m, QuadroDFS* quadro, const unsigned long long* visitados, int* destino, int* peso) {
+	const unsigned long long* linha = m->presenca + (size_t)quadro->vertice * m->palavrasLinha;
+	int p = quadro->coluna >> 6;
+	if (p >= m->palavrasLinha) return false;
+	unsigned long long livres = linha[p] & ~visitados[p] & (~0ULL << (quadro->coluna & 63));
+	while (livres == 0) {
+		if (++p >= m->palavrasLinha) {
+			quadro->coluna = p << 6;
+			return false;
+		}
+		livres = linha[p] & ~visitados[p];
+	}
+	int j = (p << 6) + BitMenosSignificativo(livres);
+	quadro->coluna = j + 1;
+	*destino = j;
+	*peso = m->pesos[(size_t)quadro->vertice * m->numVertices + j];
+	return true;
+}
+
+
+/**
+ * @brief Reserva o conjunto de visitados em bits de uma procura sobre um grafo denso.
+ *
+ * O conjunto comea com os vrtices j marcados nas primeiras numVisitado posies de visitado
+ * (por exemplo, por MarcaInalcancaveis). As colunas da matriz a partir de numVisitado ficam
+ * marcadas como visitadas, para a procura no sair dos buffers do chamador, que s tm
+ * numVisitado posies.
+ *
+ * @return O conjunto, ou NULL se o grafo no for denso, a origem estiver fora da matriz ou a
+ * alocao falhar (a procura usa ento o array de booleanos).
+ */
+static unsigned long long* CriaVisitadosBits(Grafo* g, int origem, const bool* visitado, int numVisitado) {
+	if (g->densa == NULL || origem < 0 || origem >= g->densa->numVertices) return NULL;
+	unsigned long long* visitados = (unsigned long long*)calloc((size_t)g->densa->palavrasLinha + 1, sizeof(unsigned long long));
+	if (visitados == NULL) return NULL;
+	if (numVisitado > g->densa->numVertices) numVisitado = g->densa->numVertices;
+	if (numVisitado < 0) numVisitado = 0;
+	for (int i = 0; i < numVisitado; i++) {
+		if (visitado[i]) visitados[i >> 6] |= 1ULL << (i & 63);
+	}
+	int p = numVisitado >> 6;
+	if ((numVisitado & 63) != 0) visitados[p++] |= ~0ULL << (numVisitado & 63);
+	for (; p < g->densa->palavrasLinha; p++) {
+		visitados[p] = ~0ULL;
+	}
+	return visitados;
+}
+
+
+/**
+ * @brief ProcuraProfundidadeVisita sobre a matriz densa, com os visitados num conjunto de bits.
+ */
+static void ProcuraVisitaBits(MatrizDensa* m, int origem, int destino, unsigned long long* visitados, int* caminho, QuadroDFS* pilha, VisitanteCaminho visitante, void* contexto) {
+	int topo = 0;
+	int v = origem;
+	int soma = 0;
+
+	while (true) {
+		visitados[v >> 6] |= 1ULL << (v & 63);
+		caminho[topo] = v;
+
+		if (v == destino) {
+			if (!visitante(caminho, topo + 1, soma, contexto)) break;
+			visitados[v >> 6] &= ~(1ULL << (v & 63));
+			topo--;
+		}
+		else {
+			pilha[topo].vertice = v;
+			pilha[topo].soma = soma;
+			pilha[topo].coluna = 0;
+		}
+
+		v = -1;
+		while (topo >= 0) {
+			int proximo, peso;
+			if (ProximaAdjacenciaBits(m, &pilha[topo], visitados, &proximo, &peso)) {
+				v = proximo;
+				soma = pilha[topo].soma + peso;
+				break;
+			}
+			int u = pilha[topo].vertice;
+			visitados[u >> 6] &= ~(1ULL << (u & 63)); // backtracking
+			topo--;
+		}
+		if (v < 0) break;
+		topo++;
+	}
+}
+
+
+/*
+ * Contexto de VisitanteMaiorSoma: o caminho de maior soma encontrado at agora.
+ */
+typedef struct MaiorSomaVisita {
+	int* somaMaxima;
+	int* caminhoMaximo;		//caminho seguido de -1 at numVertices posies
+	int numVertices;
+}MaiorSomaVisita;
+
+
+/**
+ * @brief Visitante que guarda o caminho de maior soma, com as regras de DFSiter (s uma soma maior o substitui).
+ */
+static bool VisitanteMaiorSoma(const int* caminho, int tamanho, int peso, void* contexto) {
+	MaiorSomaVisita* melhor = (MaiorSomaVisita*)contexto;
+	if (peso > *melhor->somaMaxima) {
+		*melhor->somaMaxima = peso;
+		for (int i = 0; i < tamanho; i++) {
+			melhor->caminhoMaximo[i] = caminho[i];
+		}
+		for (int i = tamanho; i < melhor->numVertices; i++) {
+			melhor->caminhoMaximo[i] = -1;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Procura em profundidade iterativa que entrega cada caminho encontrado a um visitante.
+ *
+ * Cada caminho entre origem e destino  passado ao visitante sem cpias, como apontador para
+ * o buffer do caminho atual, o seu tamanho e a soma dos pesos das arestas. Se o visitante
+ * devolver false a procura termina e os vrtices do caminho atual voltam a no visitados.
+ * Num grafo denso, os visitados so guardados num conjunto de bits prprio, que comea com os
+ * vrtices marcados em visitado (por exemplo, por MarcaInalcancaveis), e os vizinhos por
+ * visitar so filtrados palavra a palavra.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitado Array de booleanos que indica se um vrtice foi visitado.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param pilha Buffer de quadros com uma posio por vrtice do grafo.
+ * @param visitante Funo chamada para cada caminho encontrado.
+ * @param contexto Apontador passado ao visitante.
+ * @param numVertices Nmero de posies de visitado, caminho e pilha; num grafo denso as
+ *                    colunas da matriz a partir deste nmero so ignoradas.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* ProcuraProfundidadeVisita(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, VisitanteCaminho visitante, void* contexto, int numVertices) {
+	unsigned long long* visitados = CriaVisitadosBits(g, origem, visitado, numVertices);
+	if (visitados != NULL) {
+		ProcuraVisitaBits(g->densa, origem, destino, visitados, caminho, pilha, visitante, contexto);
+		free(visitados);
+		return g;
+	}
+
+	int topo = 0;
+	int v = origem;
+	int soma = 0;
+
+	while (true) {
+		// Entra no vrtice v, no nvel topo do caminho
+		visitado[v] = true;
+		caminho[topo] = v;
+
+		if (v == destino) {
+			if (!visitante(caminho, topo + 1, soma, contexto)) {
+				for (int i = 0; i <= topo; i++) {
+					visitado[caminho[i]] = false;
+				}
+				break;
+			}
+			visitado[v] = false;
+			topo--;
+		}
+		else {
+			IniciaQuadro(g, v, soma, &pilha[topo]);
+		}
+
+		// Avana at  prxima adjacncia por visitar, recuando quando um nvel se esgota
+		v = -1;
+		while (topo >= 0) {
+			int proximo, peso;
+			if (ProximaAdjacencia(g, &pilha[topo], visitado, &proximo, &peso)) {
+				v = proximo;
+				soma = pilha[topo].soma + peso;
+				break;
+			}
+			visitado[pilha[topo].vertice] = false; // backtracking
+			topo--;
+		}
+		if (v < 0) break;
+		topo++;
+	}
+
+	return g;
+}
+
+
+/**
+ * @brief Calcula os vrtices que podem fazer parte de um caminho entre dois vrtices de um snapshot CSR.
+ *
+ * Um vrtice s pode estar num caminho de origem at destino se for alcanvel a partir da
+ * origem e se o destino for alcanvel a partir dele. O primeiro conjunto  calculado com uma
+ * procura em largura pelas arestas, a partir da origem; o segundo, com outra procura em
+ * largura pelas arestas invertidas (s entre os vrtices do primeiro), a partir do destino.
+ * Ambas so lineares no tamanho do grafo.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem (entre 0 e csr->numVertices - 1).
+ * @param destino ID do vrtice de destino (entre 0 e csr->numVertices - 1).
+ * @param util Array com csr->numVertices posies, onde fica true para os vrtices da interseo.
+ * @return 1 se o destino  alcanvel a partir da origem, 0 se no , -1 se a alocao falhar.
+ */
+static int AlcancaveisCSR(GrafoCSR* csr, int origem, int destino, bool* util) {
+	int n = csr->numVertices;
+	bool* frente = (bool*)calloc((size_t)n + 1, sizeof(bool));	//alcanveis a partir da origem
+	int* fila = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	int* inicioInv = (int*)calloc((size_t)n + 2, sizeof(int));
+	if (frente == NULL || fila == NULL || inicioInv == NULL) {
+		free(frente);
+		free(fila);
+		free(inicioInv);
+		return -1;
+	}
+
+	// Procura em largura a partir da origem
+	int inicio = 0, fim = 0;
+	fila[fim++] = origem;
+	frente[origem] = true;
+	while (inicio < fim) {
+		int u = fila[inicio++];
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			int v = csr->destinos[a];
+			if (!frente[v]) {
+				frente[v] = true;
+				fila[fim++] = v;
+			}
+		}
+	}
+	if (!frente[destino]) {
+		free(frente);
+		free(fila);
+		free(inicioInv);
+		return 0;
+	}
+
+	// Arestas invertidas entre os vrtices alcanados, em CSR
+	for (int u = 0; u < n; u++) {
+		if (!frente[u]) continue;
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			inicioInv[csr->destinos[a] + 2]++;
+		}
+	}
+	for (int v = 0; v < n; v++) {
+		inicioInv[v + 2] += inicioInv[v + 1];
+	}
+	int* origensInv = (int*)malloc(((size_t)inicioInv[n + 1] + 1) * sizeof(int));
+	if (origensInv == NULL) {
+		free(frente);
+		free(fila);
+		free(inicioInv);
+		return -1;
+	}
+	for (int u = 0; u < n; u++) {
+		if (!frente[u]) continue;
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			origensInv[inicioInv[csr->destinos[a] + 1]++] = u;
+		}
+	}
+
+	// Procura em largura a partir do destino, pelas arestas invertidas
+	memset(util, 0, (size_t)n * sizeof(bool));
+	inicio = 0;
+	fim = 0;
+	fila[fim++] = destino;
+	util[destino] = true;
+	while (inicio < fim) {
+		int v = fila[inicio++];
+		for (int a = inicioInv[v]; a < inicioInv[v + 1]; a++) {
+			int u = origensInv[a];
+			if (!util[u]) {
+				util[u] = true;
+				fila[fim++] = u;
+			}
+		}
+	}
+
+	free(frente);
+	free(fila);
+	free(inicioInv);
+	free(origensInv);
+	return 1;
+}
+
+
+/**
+ * @brief Faz o trabalho de MarcaInalcancaveis sobre um snapshot CSR j congelado.
+ */
+static bool MarcaInalcancaveisCSR(GrafoCSR* csr, int origem, int destino, bool* visitado, int numVertices) {
+	if (csr == NULL || visitado == NULL || origem < 0 || origem >= numVertices || destino < 0 || destino >= numVertices) {
+		return true;
+	}
+	if (origem >= csr->numVertices || destino >= csr->numVertices) return true;
+
+	bool* util = (bool*)malloc(((size_t)csr->numVertices + 1) * sizeof(bool));
+	int alcanca = (util != NULL) ? AlcancaveisCSR(csr, origem, destino, util) : -1;
+	if (alcanca == 1) {
+		for (int v = 0; v < numVertices; v++) {
+			if (v >= csr->numVertices || !util[v]) visitado[v] = true;
+		}
+	}
+	free(util);
+	return alcanca != 0;
+}
+
+
+/**
+ * @brief Marca como visitados os vrtices que no podem estar em nenhum caminho entre dois vrtices.
+ *
+ * Deve ser chamada antes de uma procura em profundidade (ProcuraProfundidadeRec, DFSrec,
+ * DFSiter, ...), com o array visitado ainda por usar: como as procuras no entram em vrtices
+ * visitados, deixam de explorar ramos que nunca chegam ao destino. Os caminhos encontrados, e a
+ * ordem em que o so, no mudam. Ver AlcancaveisCSR.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param visitado Array de booleanos da procura, com numVertices posies.
+ * @param numVertices Nmero de posies de visitado.
+ * @return false se se sabe que no existe caminho de origem at destino (a procura pode ser
+ * dispensada), true caso contrrio, incluindo quando no foi possvel calcular os conjuntos.
+ */
+bool MarcaInalcancaveis(Grafo* g, int origem, int destino, bool* visitado, int numVertices) {
+	if (g == NULL || visitado == NULL || origem < 0 || origem >= numVertices || destino < 0 || destino >= numVertices) {
+		return true;
+	}
+	GrafoCSR* csr = CongelaGrafo(g);
+	if (csr == NULL) return true;
+	bool alcanca = MarcaInalcancaveisCSR(csr, origem, destino, visitado, numVertices);
+	DestroiGrafoCSR(csr);
+	return alcanca;
+}
+
+
+/**
+ * @brief Entrega a um visitante todos os caminhos entre dois vrtices do grafo.
+ *
+ * Reserva os buffers da procura e chama ProcuraProfundidadeVisita, depois de marcar com
+ * MarcaInalcancaveis os vrtices que no levam ao destino.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param numVertices O nmero de vrtices no grafo.
+ * @param visitante Funo chamada para cada caminho encontrado.
+ * @param contexto Apontador passado ao visitante.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* PercorreCaminhos(Grafo* g, int origem, int destino, int numVertices, VisitanteCaminho visitante, void* contexto) {
+	if (g == NULL || visitante == NULL || origem < 0 || origem >= numVertices) return g;
+
+	bool* visitado = (bool*)calloc(numVertices, sizeof(bool));
+	int* caminho = (int*)malloc(numVertices * sizeof(int));
+	QuadroDFS* pilha = (QuadroDFS*)malloc(numVertices * sizeof(QuadroDFS));
+	if (visitado != NULL && caminho != NULL && pilha != NULL && MarcaInalcancaveis(g, origem, destino, visitado, numVertices)) {
+		ProcuraProfundidadeVisita(g, origem, destino, visitado, caminho, pilha, visitante, contexto, numVertices);
+	}
+
+	free(visitado);
+	free(caminho);
+	free(pilha);
+	return g;
+}
+
+
+/**
+ * @brief Visitante que mostra cada caminho e acumula a soma dos valores dos seus vrtices.
+ *
+ *  o visitante usado por ProcuraProfundidade.
+ *
+ * @param caminho Os vrtices do caminho.
+ * @param tamanho O nmero de vrtices do caminho.
+ * @param peso A soma dos pesos das arestas do caminho (no utilizado).
+ * @param contexto Apontador para o int onde se acumula a soma dos vrtices dos caminhos.
+ * @return true, para continuar a procura.
+ */
+bool VisitanteMostraCaminho(const int* caminho, int tamanho, int peso, void* contexto) {
+	(void)peso; // a soma mostrada  a dos vrtices, no a dos pesos
+	int soma = 0;
+	for (int i = 0; i < tamanho; i++) {
+		printf("%d ", caminho[i]);
+		soma += caminho[i];
+	}
+	printf("\n");
+
+	*(int*)contexto += soma;
+	return true;
+}
+
+
+/**
+ * @brief Realiza uma procura em profundidade (DFS) em um grafo para encontrar o caminho com a maior soma de pesos entre dois vrtices.
+ *
+ * Esta funo percorre recursivamente o grafo a partir de um vrtice de origem, procurando o vrtice de destino. Durante o percurso,
+ * calcula a soma dos pesos das arestas no caminho e compara com a maior soma j encontrada at o momento.
+ * Para no explorar ramos sem sada, o array visitado pode ser preparado com MarcaInalcancaveis.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param visitado Array de booleanos indicando se um vrtice foi visitado durante o percurso.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param indice ndice atual no caminho.
+ * @param somaCaminhos Apontador para a varivel que armazena a soma dos pesos dos caminhos encontrados (no utilizado nesta funo).
+ * @param somaMaxima Apontador para a varivel que armazena a maior soma de pesos encontrada.
+ * @param caminhoMaximo Array para armazenar o caminho correspondente  maior soma encontrada.
+ * @param numVertices Nmero total de vrtices no grafo.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* DFSrec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos, int* somaMaxima, int* caminhoMaximo, int numVertices) {
+	visitado[origem] = true;
+	caminho[indice] = origem; // Armazena o ID do vrtice atual no caminho
+	indice++;
+
+	if (origem == destino) {
+		// Calcula a soma dos pesos das arestas no caminho
+		int soma = 0;
+		for (int i = 0; i < indice - 1; i++) {
+			// Localiza o vrtice atual atravs do ndice do grafo
+			Vertices* verticeAtual = OndeEstaVerticeGrafo(g, caminho[i]);
+			// Verifica se o vrtice atual foi encontrado
+			if (verticeAtual == NULL) {
+				return NULL;
+			}
+			// Peso da aresta para o vrtice seguinte (tempo constante com a tabela de arestas ativa)
+			int peso;
+			if (PesoAresta(g, caminho[i], caminho[i + 1], &peso)) {
+				soma += peso;
+			}
+		}
+
+		// Verifica se a soma  maior que a soma mxima encontrada at agora
+		if (soma > *somaMaxima) {
+			*somaMaxima = soma;
+			// Atualiza o caminho mximo correspondente
+			for (int i = 0; i < indice; i++) {
+				caminhoMaximo[i] = caminho[i];
+			}
+			// Define -1 nos elementos restantes do caminho mximo
+			for (int i = indice; i < numVertices; i++) {
+				caminhoMaximo[i] = -1;
+			}
+		}
+	}
+	else {
+		// Se o vrtice atual no  o destino, procura as adjacncias
+		// Localiza o vrtice atual atravs do ndice do grafo
+		Vertices* verticeAtual = OndeEstaVerticeGrafo(g, origem);
+		// Verifica se o vrtice atual foi encontrado
+		if (verticeAtual == NULL) {
+			return NULL;
+		}
+		// Percorre as adjacncias do vrtice atual ainda no visitadas
+		QuadroDFS quadro;
+		int proximo, peso;
+		IniciaQuadro(g, origem, 0, &quadro);
+		while (ProximaAdjacencia(g, &quadro, visitado, &proximo, &peso)) {
+			DFSrec(g, proximo, destino, visitado, caminho, indice, somaCaminhos, somaMaxima, caminhoMaximo, numVertices);
+		}
+	}
+
+	// Backtracking
+	indice--;
+	visitado[origem] = false;
+	return g;
+}
+
+
+
+/**
+ * @brief Mostra a soma mxima e o caminho correspondente, no formato de encontrarCaminhoMaiorSoma.
+ */
+static void MostraCaminhoMaiorSoma(int somaMaxima, const int* caminho, int tamanho) {
+	printf("Soma mxima: %d\n", somaMaxima);
+	printf("Caminho correspondente: ");
+	for (int i = 0; i < tamanho; i++) {
+		printf("%d ", caminho[i]);
+	}
+	printf("\n");
+}
+
+
+/**
+ * @brief Mostra o algoritmo usado por encontrarCaminhoMaiorSoma.
+ */
+static void MostraMotorCaminho(MotorCaminho motor) {
+	const char* nome = "procura exaustiva";
+	if (motor == MOTOR_PODA) nome = "procura com poda";
+	else if (motor == MOTOR_HELDKARP) nome = "Held-Karp";
+	else if (motor == MOTOR_PARALELO) nome = "procura paralela";
+	else if (motor == MOTOR_COMPONENTES) nome = "componentes fortemente conexas";
+	else if (motor == MOTOR_DAG) nome = "ordem topolgica (grafo sem ciclos)";
+	printf("Motor utilizado: %s\n", nome);
+}
+
+
+/**
+ * @brief Escolhe o algoritmo de MOTOR_AUTOMATICO conforme os vrtices que podem estar no caminho.
+ *
+ * Sem ciclos no caminho (s componentes de um vrtice), basta a ordem topolgica; com mais de
+ * uma componente fortemente conexa, a procura  feita por componente; com uma s, ou sem
+ * caminho, a procura  exaustiva.
+ */
+static MotorCaminho EscolheMotorCaminho(GrafoCSR* csr, int origem, int destino) {
+	MotorCaminho motor = MOTOR_EXAUSTIVO;
+	ComponentesFortes* componentes = ComponentesCaminhoCSR(csr, origem, destino);
+	if (componentes != NULL && componentes->numComponentes == componentes->inicioMembros[componentes->numComponentes]) {
+		motor = MOTOR_DAG;
+	}
+	else if (componentes != NULL && componentes->numComponentes > 1) {
+		motor = MOTOR_COMPONENTES;
+	}
+	DestroiComponentesFortes(componentes);
+	return motor;
+}
+
+
+// Definidas na regio da cache de caminhos
+static EntradaCache* UsaEntradaCache(Grafo* g, int origem, int destino, MotorCaminho motor);
+static void GuardaEntradaCache(Grafo* g, int origem, int destino, MotorCaminho motor, MotorCaminho motorUsado, const int* caminho, int tamanho, int soma);
+
+
+/**
+ * @brief Encontra o caminho que proporciona a maior soma possvel dos inteiros no grafo, seguindo a regra de conexo estabelecida.
+ *
+ * Esta funo realiza uma busca em profundidade (DFS) no grafo a partir de um vrtice de origem, procurando o vrtice de destino.
+ * Durante o percurso, calcula a soma dos pesos das arestas no caminho e compara com a maior soma j encontrada at o momento.
+ * Os vrtices que no podem chegar ao destino so excludos antes da procura (ver
+ * MarcaInalcancaveis). Se os restantes no formarem ciclos, o caminho  calculado em tempo
+ * linear por ordem topolgica (ver CaminhoMaiorSomaDAGCSR); se formarem vrias componentes
+ * fortemente conexas, a procura  feita por componente e combinada pela condensao (ver
+ * CaminhoMaiorSomaComponentesCSR). Nos dois casos a soma  a mesma, mas entre caminhos empatados
+ * pode ser escolhido outro. Ao final, exibe a soma mxima, o caminho correspondente e o
+ * algoritmo utilizado. Com a cache de caminhos ativa (ver AtivaCacheCaminhos), a consulta 
+ * guardada com MOTOR_AUTOMATICO e, repetida sem alteraes no grafo, no refaz a procura nem a
+ * escolha do algoritmo.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param numVertices Nmero total de vrtices no grafo.
+ */
+void encontrarCaminhoMaiorSoma(Grafo* g, int origem, int destino, int numVertices) {
+	int somaMaxima = 0;
+	int tamanho = 0;
+
+	// A consulta fica na cache com MOTOR_AUTOMATICO: o motor s  escolhido se no estiver l
+	if (g != NULL && g->cache != NULL) {
+		EntradaCache* e = UsaEntradaCache(g, origem, destino, MOTOR_AUTOMATICO);
+		if (e != NULL) {
+			MostraCaminhoMaiorSoma(e->soma, e->caminho, e->tamanho);
+			MostraMotorCaminho(e->motorUsado);
+			return;
+		}
+	}
+
+	// O mesmo snapshot serve para escolher o motor e para a procura
+	GrafoCSR* csr = CongelaGrafo(g);
+	MotorCaminho motor = (csr != NULL) ? EscolheMotorCaminho(csr, origem, destino) : MOTOR_EXAUSTIVO;
+	if (motor != MOTOR_EXAUSTIVO) {
+		int* caminho = (int*)malloc(sizeof(int) * ((size_t)csr->numVertices + 1));
+		if (caminho != NULL) {
+			somaMaxima = CaminhoMaiorSomaCSR(csr, origem, destino, motor, caminho, &tamanho);
+			GuardaEntradaCache(g, origem, destino, MOTOR_AUTOMATICO, motor, caminho, tamanho, somaMaxima);
+			MostraCaminhoMaiorSoma(somaMaxima, caminho, tamanho);
+			MostraMotorCaminho(motor);
+			free(caminho);
+		}
+		DestroiGrafoCSR(csr);
+		return;
+	}
+
+	bool* visitado = (bool*)malloc(sizeof(bool) * numVertices);
+
+	int* caminho = (int*)malloc(sizeof(int) * numVertices);
+	QuadroDFS* pilha = (QuadroDFS*)malloc(sizeof(QuadroDFS) * numVertices);
+	int* caminhoMaximo = (int*)malloc(sizeof(int) * numVertices);
+	if (visitado == NULL || caminho == NULL || pilha == NULL || caminhoMaximo == NULL) {
+		free(visitado);
+		free(caminho);
+		free(pilha);
+		free(caminhoMaximo);
+		DestroiGrafoCSR(csr);
+		return;
+	}
+
+	// Inicializa todos os vrtices como no visitados e o caminho mximo como vazio
+	for (int i = 0; i < numVertices; i++) {
+		visitado[i] = false;
+		caminhoMaximo[i] = -1;
+	}
+
+	bool procura = (csr != NULL) ? MarcaInalcancaveisCSR(csr, origem, destino, visitado, numVertices) : MarcaInalcancaveis(g, origem, destino, visitado, numVertices);
+	DestroiGrafoCSR(csr);
+	if (procura) {
+		DFSiter(g, origem, destino, visitado, caminho, pilha, &somaMaxima, caminhoMaximo, numVertices);
+	}
+
+	// O caminho mximo ocupa o incio do array e o resto fica a -1
+	while (tamanho < numVertices && caminhoMaximo[tamanho] != -1) {
+		tamanho++;
+	}
+	GuardaEntradaCache(g, origem, destino, MOTOR_AUTOMATICO, MOTOR_EXAUSTIVO, caminhoMaximo, tamanho, somaMaxima);
+	MostraCaminhoMaiorSoma(somaMaxima, caminhoMaximo, tamanho);
+	MostraMotorCaminho(MOTOR_EXAUSTIVO);
+
+	free(visitado);
+	free(caminho);
+	free(pilha);
+	free(caminhoMaximo);
+}
+
+
+/**
+ * @brief Procura iterativa do caminho com a maior soma de pesos entre dois vrtices.
+ *
+ * Verso iterativa de DFSrec com o mesmo resultado. Usa uma pilha explcita de quadros
+ * (vrtice, prxima adjacncia a explorar, soma at ao vrtice) num nico buffer, e acumula
+ * o peso do caminho  medida que desce em vez de o recalcular em cada caminho completo.
+ * Num grafo denso, tal como ProcuraProfundidadeVisita, usa um conjunto de bits de visitados.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param visitado Array de booleanos indicando se um vrtice foi visitado durante o percurso.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param pilha Buffer de quadros com uma posio por vrtice do grafo.
+ * @param somaMaxima Apontador para a varivel que armazena a maior soma de pesos encontrada.
+ * @param caminhoMaximo Array para armazenar o caminho correspondente  maior soma encontrada.
+ * @param numVertices Nmero total de vrtices no grafo; num grafo denso as colunas da matriz
+ *                    a partir deste nmero so ignoradas.
+ * @return Apontador para a estrutura do grafo.
+ */
+Grafo* DFSiter(Grafo* g, int origem, int destino, bool* visitado, int* caminho, QuadroDFS* pilha, int* somaMaxima, int* caminhoMaximo, int numVertices) {
+	unsigned long long* visitados = CriaVisitadosBits(g, origem, visitado, numVertices);
+	if (visitados != NULL) {
+		MaiorSomaVisita melhor = { somaMaxima, caminhoMaximo, numVertices };
+		ProcuraVisitaBits(g->densa, origem, destino, visitados, caminho, pilha, VisitanteMaiorSoma, &melhor);
+		free(visitados);
+		return g;
+	}
+
+	int topo = 0;
+	int v = origem;
+	int soma = 0;
+
+	while (true) {
+		// Entra no vrtice v, no nvel topo do caminho, com a soma acumulada at ele
+		visitado[v] = true;
+		caminho[topo] = v;
+
+		if (v == destino) {
+			if (soma > *somaMaxima) {
+				*somaMaxima = soma;
+				for (int i = 0; i <= topo; i++) {
+					caminhoMaximo[i] = caminho[i];
+				}
+				for (int i = topo + 1; i < numVertices; i++) {
+					caminhoMaximo[i] = -1;
+				}
+			}
+			visitado[v] = false;
+			topo--;
+		}
+		else {
+			IniciaQuadro(g, v, soma, &pilha[topo]);
+		}
+
+		// Avana at  prxima adjacncia por visitar, recuando quando um nvel se esgota
+		v = -1;
+		while (topo >= 0) {
+			int proximo, peso;
+			if (ProximaAdjacencia(g, &pilha[topo], visitado, &proximo, &peso)) {
+				v = proximo;
+				soma = pilha[topo].soma + peso;
+				break;
+			}
+			visitado[pilha[topo].vertice] = false; // backtracking
+			topo--;
+		}
+		if (v < 0) break;
+		topo++;
+	}
+
+	return g;
+}
+
+
+
+#pragma region Cache
+
+/*
+ * Cache das procuras do caminho de maior soma. Cada entrada guarda o resultado de uma consulta
+ * (origem, destino, motor) e a verso do grafo em que foi calculado; como todas as alteraes
+ * do grafo incrementam a verso, uma entrada de outra verso  tratada como ausente. As entradas
+ * formam uma lista pela ordem de utilizao: um acerto passa a entrada para o incio e, com a
+ * cache cheia,  reutilizada a do fim. A capacidade  pequena, pelo que a procura  linear.
+ */
+
+static void DesligaEntradaCache(CacheCaminhos* cache, EntradaCache* e) {
+	if (e->anterior != NULL) e->anterior->seguinte = e->seguinte;
+	else cache->maisRecente = e->seguinte;
+	if (e->seguinte != NULL) e->seguinte->anterior = e->anterior;
+	else cache->menosRecente = e->anterior;
+	e->anterior = NULL;
+	e->seguinte = NULL;
+}
+
+
+static void LigaEntradaCache(CacheCaminhos* cache, EntradaCache* e) {
+	e->anterior = NULL;
+	e->seguinte = cache->maisRecente;
+	if (cache->maisRecente != NULL) cache->maisRecente->anterior = e;
+	cache->maisRecente = e;
+	if (cache->menosRecente == NULL) cache->menosRecente = e;
+}
+
+
+static EntradaCache* ProcuraEntradaCache(CacheCaminhos* cache, int origem, int destino, MotorCaminho motor) {
+	for (EntradaCache* e = cache->maisRecente; e != NULL; e = e->seguinte) {
+		if (e->origem == origem && e->destino == destino && e->motor == motor) return e;
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief Devolve a entrada vlida de uma consulta (passando-a a mais recente), ou NULL; conta o acerto ou a falha.
+ */
+static EntradaCache* UsaEntradaCache(Grafo* g, int origem, int destino, MotorCaminho motor) {
+	CacheCaminhos* cache = g->cache;
+	EntradaCache* e = ProcuraEntradaCache(cache, origem, destino, motor);
+	if (e == NULL || e->versao != g->versao) {
+		cache->falhas++;
+		return NULL;
+	}
+	DesligaEntradaCache(cache, e);
+	LigaEntradaCache(cache, e);
+	cache->acertos++;
+	return e;
+}
+
+
+/**
+ * @brief Ativa a cache dos resultados das procuras do caminho de maior soma.
+ *
+ * Com a cache ativa, encontrarCaminhoMaiorSoma e encontrarCaminhoMaiorSomaModo devolvem o
+ * resultado guardado quando a mesma consulta  repetida sem alteraes no grafo entretanto.
+ *
+ * @param g Um apontador para o grafo.
+ * @param capacidade Nmero mximo de consultas guardadas (0 ou negativo para CAPACIDADECACHE).
+ * @return true se a cache ficou ativa, false se a alocao falhar.
+ */
+bool AtivaCacheCaminhos(Grafo* g, int capacidade) {
+	if (g == NULL) return false;
+	if (capacidade <= 0) capacidade = CAPACIDADECACHE;
+	DesativaCacheCaminhos(g);
+
+	CacheCaminhos* cache = (CacheCaminhos*)malloc(sizeof(CacheCaminhos));
+	if (cache == NULL) return false;
+	cache->entradas = (EntradaCache*)calloc(capacidade, sizeof(EntradaCache));
+	if (cache->entradas == NULL) {
+		free(cache);
+		return false;
+	}
+	cache->capacidade = capacidade;
+	cache->ocupadas = 0;
+	cache->maisRecente = NULL;
+	cache->menosRecente = NULL;
+	cache->acertos = 0;
+	cache->falhas = 0;
+	g->cache = cache;
+	return true;
+}
+
+
+/**
+ * @brief Desativa a cache de caminhos do grafo e liberta os resultados guardados.
+ *
+ * @param g Um apontador para o grafo.
+ */
+void DesativaCacheCaminhos(Grafo* g) {
+	if (g == NULL || g->cache == NULL) return;
+	for (int i = 0; i < g->cache->ocupadas; i++) {
+		free(g->cache->entradas[i].caminho);
+	}
+	free(g->cache->entradas);
+	free(g->cache);
+	g->cache = NULL;
+}
+
+
+/**
+ * @brief Procura na cache o resultado de uma consulta, para a verso atual do grafo.
+ *
+ * Conta um acerto ou uma falha nas estatsticas da cache.
+ *
+ * @param g Um apontador para o grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param motor Algoritmo da consulta.
+ * @param caminho Array onde  copiado o caminho guardado (pode ser NULL).
+ * @param tamanho Apontador para o nmero de vrtices do caminho.
+ * @param soma Apontador para a soma do caminho.
+ * @return true se o resultado estava na cache, false caso contrrio (ou se a cache no est ativa).
+ */
+bool ConsultaCacheCaminhos(Grafo* g, int origem, int destino, MotorCaminho motor, int* caminho, int* tamanho, int* soma) {
+	if (g == NULL || g->cache == NULL) return false;
+
+	EntradaCache* e = UsaEntradaCache(g, origem, destino, motor);
+	if (e == NULL) return false;
+	if (caminho != NULL && e->tamanho > 0) memcpy(caminho, e->caminho, e->tamanho * sizeof(int));
+	*tamanho = e->tamanho;
+	*soma = e->soma;
+	return true;
+}
+
+
+/**
+ * @brief Guarda na cache o resultado de uma consulta, calculado na verso atual do grafo.
+ *
+ * Substitui o resultado anterior da mesma consulta ou, se a cache estiver cheia, o da consulta
+ * usada h mais tempo. Se no houver memria para copiar o caminho, o resultado no  guardado.
+ *
+ * @param g Um apontador para o grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param motor Algoritmo da consulta.
+ * @param caminho Os vrtices do caminho encontrado.
+ * @param tamanho O nmero de vrtices do caminho (0 se no existir).
+ * @param soma A soma do caminho.
+ */
+void GuardaCacheCaminhos(Grafo* g, int origem, int destino, MotorCaminho motor, const int* caminho, int tamanho, int soma) {
+	GuardaEntradaCache(g, origem, destino, motor, motor, caminho, tamanho, soma);
+}
+
+
+/**
+ * @brief Faz o trabalho de GuardaCacheCaminhos, registando tambm o algoritmo que calculou o resultado.
+ */
+static void GuardaEntradaCache(Grafo* g, int origem, int destino, MotorCaminho motor, MotorCaminho motorUsado, const int* caminho, int tamanho, int soma) {
+	if (g == NULL || g->cache == NULL) return;
+	CacheCaminhos* cache = g->cache;
+
+	int* copia = (int*)malloc(((size_t)tamanho + 1) * sizeof(int));
+	if (copia == NULL) return;
+	if (tamanho > 0) memcpy(copia, caminho, tamanho * sizeof(int));
+
+	EntradaCache* e = ProcuraEntradaCache(cache, origem, destino, motor);
+	if (e == NULL && cache->ocupadas < cache->capacidade) {
+		e = &cache->entradas[cache->ocupadas++];
+	}
+	else {
+		if (e == NULL) e = cache->menosRecente;
+		DesligaEntradaCache(cache, e);
+		free(e->caminho);
+	}
+
+	e->origem = origem;
+	e->destino = destino;
+	e->motor = motor;
+	e->motorUsado = motorUsado;
+	e->versao = g->versao;
+	e->soma = soma;
+	e->tamanho = tamanho;
+	e->caminho = copia;
+	LigaEntradaCache(cache, e);
+}
+
+
+/**
+ * @brief Devolve os contadores de acertos e falhas da cache de caminhos.
+ *
+ * @param g Um apontador para o grafo.
+ * @param acertos Apontador para o nmero de consultas respondidas pela cache.
+ * @param falhas Apontador para o nmero de consultas que tiveram de ser calculadas.
+ */
+void EstatisticasCacheCaminhos(Grafo* g, long long* acertos, long long* falhas) {
+	*acertos = (g != NULL && g->cache != NULL) ? g->cache->acertos : 0;
+	*falhas = (g != NULL && g->cache != NULL) ? g->cache->falhas : 0;
+}
+
+#pragma endregion
+
+#pragma region CSR
+
+/**
+ * @brief Devolve os ids dos vrtices de um grafo, por ordem crescente.
+ *
+ * @param g Apontador para o grafo.
+ * @param numIds Apontador onde fica o nmero de vrtices.
+ * @return O vetor de ids, a libertar com free, ou NULL se houver ids negativos ou a alocao falhar.
+ */
+static int* IdsVerticesGrafo(Grafo* g, int* numIds) {
+	int n = 0;
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		if (v->id < 0) return NULL;
+		n++;
+	}
+	int* ids = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	if (ids == NULL) return NULL;
+
+	int i = 0;
+	bool ordenados = true;
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		ids[i] = v->id;
+		if (i > 0 && ids[i] < ids[i - 1]) ordenados = false;
+		i++;
+	}
+	if (!ordenados) qsort(ids, n, sizeof(int), ComparaInteiros);
+	*numIds = n;
+	return ids;
+}
+
+
+/**
+ * @brief Verifica se um vetor de ids  estritamente crescente e est em [0, numVertices).
+ */
+static bool IdsValidos(const int* ids, int numIds, int numVertices) {
+	for (int k = 0; k < numIds; k++) {
+		if (ids[k] < 0 || ids[k] >= numVertices || (k > 0 && ids[k] <= ids[k - 1])) return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Reduz os offsets de um CSR (um por id) a um por vrtice existente, para guardar.
+ *
+ * @return O vetor de numIds + 1 offsets, a libertar com free, ou NULL se algum id que no est
+ * na lista tiver arestas de sada ou a alocao falhar.
+ */
+static int* ReduzOffsets(const int* inicioAdj, const int* ids, int numIds, int numArestas) {
+	int* offsets = (int*)malloc(((size_t)numIds + 1) * sizeof(int));
+	if (offsets == NULL) return NULL;
+	int esperado = 0;
+	for (int k = 0; k < numIds; k++) {
+		if (inicioAdj[ids[k]] != esperado) {
+			free(offsets);
+			return NULL;
+		}
+		offsets[k] = esperado;
+		esperado = inicioAdj[ids[k] + 1];
+	}
+	if (esperado != numArestas) {
+		free(offsets);
+		return NULL;
+	}
+	offsets[numIds] = numArestas;
+	return offsets;
+}
+
+
+/**
+ * @brief Expande os offsets de um ficheiro, um por vrtice existente, para um por id.
+ *
+ * Os ids sem vrtice ficam com um intervalo vazio, no incio do vrtice seguinte.
+ *
+ * @return O vetor de numVertices + 1 offsets, a libertar com free, ou NULL se a alocao falhar.
+ */
+static int* ExpandeOffsets(const int* offsets, const int* ids, int numIds, int numVertices) {
+	int* inicioAdj = (int*)malloc(((size_t)numVertices + 1) * sizeof(int));
+	if (inicioAdj == NULL) return NULL;
+	int k = 0;
+	for (int v = 0; v <= numVertices; v++) {
+		inicioAdj[v] = offsets[k];
+		if (k < numIds && ids[k] == v) k++;
+	}
+	return inicioAdj;
+}
+
+
+/**
+ * @brief Congela um grafo na representao densa: as linhas da matriz passam a segmentos do CSR.
+ */
+static GrafoCSR* CongelaGrafoDenso(Grafo* g) {
+	MatrizDensa* m = g->densa;
+	int maiorId = m->numVertices - 1;
+	for (Vertices* v = g->inicioGrafo; v != NULL; v = v->proxVertice) {
+		if (v->id > maiorId) maiorId = v->id;
+	}
+	int numArestas = 0;
+	for (size_t i = 0; i < (size_t)m->numVertices * m->palavrasLinha; i++) {
+		numArestas += ContaBits(m->presenca[i]);
+	}
+
+	GrafoCSR* csr = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+	if (csr == NULL) return NULL;
+	csr->ficheiro = NULL;
+	csr->offsetsAlocados = false;
+	csr->numVertices = maiorId + 1;
+	csr->numArestas = numArestas;
+	csr->inicioAdj = (int*)calloc((size_t)csr->numVertices + 1, sizeof(int));
+	csr->destinos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->pesos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->ids = IdsVerticesGrafo(g, &csr->numIds);
+	if (csr->inicioAdj == NULL || csr->destinos == NULL || csr->pesos == NULL || csr->ids == NULL) {
+		DestroiGrafoCSR(csr);
+		return NULL;
+	}
+
+	int pos = 0;
+	for (int i = 0; i < csr->numVertices; i++) {
+		csr->inicioAdj[i] = pos;
+		if (i >= m->numVertices) continue;
+		const unsigned long long* linha = m->presenca + (size_t)i * m->palavrasLinha;
+		for (int p = 0; p < m->palavrasLinha; p++) {
+			unsigned long long palavra = linha[p];
+			while (palavra != 0) {
+				int j = p * 64 + BitMenosSignificativo(palavra);
+				csr->destinos[pos] = j;
+				csr->pesos[pos] = m->pesos[(size_t)i * m->numVertices + j];
+				pos++;
+				palavra &= palavra - 1;
+			}
+		}
+	}
+	csr->inicioAdj[csr->numVertices] = pos;
+	return csr;
+}
+
+
+/**
+ * @brief Congela um grafo numa representao CSR (compressed sparse row) s de leitura.
+ *
+ * Esta funo copia as listas de adjacncias do grafo para trs vetores contguos:
+ * os offsets de cada vrtice, os destinos e os pesos das arestas. A ordem das arestas
+ * de cada vrtice  preservada, pelo que as procuras sobre o CSR visitam os caminhos
+ * pela mesma ordem que as procuras sobre as listas. Os ids dos vrtices, com ou sem arestas,
+ * ficam guardados  parte. O snapshot no acompanha alteraes posteriores do grafo e deve ser
+ * reconstrudo sempre que este for modificado.
+ *
+ * @param g Apontador para o grafo a congelar.
+ * @return Um apontador para o snapshot CSR, ou NULL se o grafo for invlido (ids negativos) ou
+ * a alocao falhar.
+ */
+GrafoCSR* CongelaGrafo(Grafo* g) {
+	if (g == NULL) return NULL;
+	if (g->densa != NULL) return CongelaGrafoDenso(g);
+
+	// Primeira passagem: dimenso do espao de ids e nmero de arestas
+	int maiorId = -1;
+	int numArestas = 0;
+	Vertices* v = g->inicioGrafo;
+	while (v != NULL) {
+		if (v->id < 0) return NULL; // ids negativos no podem indexar o CSR
+		if (v->id > maiorId) maiorId = v->id;
+		Adjacencias* adj = v->proxAdj;
+		while (adj != NULL) {
+			if (adj->id < 0) return NULL;
+			if (adj->id > maiorId) maiorId = adj->id;
+			numArestas++;
+			adj = adj->next;
+		}
+		v = v->proxVertice;
+	}
+
+	GrafoCSR* csr = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+	if (csr == NULL) return NULL;
+	csr->ficheiro = NULL;
+	csr->offsetsAlocados = false;
+	csr->numVertices = maiorId + 1;
+	csr->numArestas = numArestas;
+	csr->inicioAdj = (int*)calloc((size_t)csr->numVertices + 1, sizeof(int));
+	csr->destinos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->pesos = (int*)malloc(((size_t)numArestas + 1) * sizeof(int));
+	csr->ids = IdsVerticesGrafo(g, &csr->numIds);
+	if (csr->inicioAdj == NULL || csr->destinos == NULL || csr->pesos == NULL || csr->ids == NULL) {
+		DestroiGrafoCSR(csr);
+		return NULL;
+	}
+
+	// Segunda passagem: graus de sada de cada vrtice
+	v = g->inicioGrafo;
+	while (v != NULL) {
+		Adjacencias* adj = v->proxAdj;
+		while (adj != NULL) {
+			csr->inicioAdj[v->id + 1]++;
+			adj = adj->next;
+		}
+		v = v->proxVertice;
+	}
+	for (int i = 0; i < csr->numVertices; i++) {
+		csr->inicioAdj[i + 1] += csr->inicioAdj[i];
+	}
+
+	// Terceira passagem: copia destinos e pesos pela ordem das listas
+	v = g->inicioGrafo;
+	while (v != NULL) {
+		int pos = csr->inicioAdj[v->id];
+		Adjacencias* adj = v->proxAdj;
+		while (adj != NULL) {
+			csr->destinos[pos] = adj->id;
+			csr->pesos[pos] = adj->peso;
+			pos++;
+			adj = adj->next;
+		}
+		v = v->proxVertice;
+	}
+
+	return csr;
+}
+
+
+/**
+ * @brief Liberta a memria de um snapshot CSR.
+ *
+ * @param csr Apontador para o snapshot a destruir (pode ser NULL).
+ */
+void DestroiGrafoCSR(GrafoCSR* csr) {
+	if (csr == NULL) return;
+	if (csr->ficheiro != NULL) {
+		// Os vetores apontam para o ficheiro mapeado, exceto os offsets expandidos
+		DesmapeiaFicheiro(csr->ficheiro);
+		free(csr->ficheiro);
+		if (csr->offsetsAlocados) free(csr->inicioAdj);
+	}
+	else {
+		free(csr->inicioAdj);
+		free(csr->destinos);
+		free(csr->pesos);
+		free(csr->ids);
+	}
+	free(csr);
+}
+
+
+/**
+ * @brief Reconstri um grafo altervel a partir de um snapshot CSR.
+ *
+ *  criado um vrtice para cada id da lista de vrtices do snapshot, com ou sem arestas, e
+ * para cada destino de uma aresta, por ordem crescente, e as adjacncias de cada um pela
+ * ordem do snapshot.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @return Um apontador para o grafo criado, ou NULL em caso de erro.
+ */
+Grafo* DescongelaGrafo(GrafoCSR* csr) {
+	if (csr == NULL) return NULL;
+
+	Grafo* g = CriaGrafo();
+	if (g == NULL) return NULL;
+	int n = csr->numVertices;
+	if (n == 0) return g;
+
+	bool* existe = (bool*)calloc(n, sizeof(bool));
+	if (existe == NULL || !AumentaIndiceVertices(g, n - 1, n)) {
+		free(existe);
+		DestroiGrafo(g);
+		return NULL;
+	}
+	for (int k = 0; k < csr->numIds; k++) {
+		existe[csr->ids[k]] = true;
+	}
+	for (int v = 0; v < n; v++) {
+		if (csr->inicioAdj[v] < csr->inicioAdj[v + 1]) existe[v] = true;
+	}
+	for (int a = 0; a < csr->numArestas; a++) {
+		existe[csr->destinos[a]] = true;
+	}
+
+	Vertices* ultimo = NULL;
+	bool ok = true;
+	for (int v = 0; v < n && ok; v++) {
+		if (!existe[v]) continue;
+		Vertices* novo = CriaVerticeArena(g, v);
+		if (novo == NULL) {
+			ok = false;
+			break;
+		}
+		Adjacencias* cauda = NULL;
+		for (int a = csr->inicioAdj[v]; a < csr->inicioAdj[v + 1]; a++) {
+			Adjacencias* adj = NovaAdjacenciaArena(g, csr->destinos[a], csr->pesos[a]);
+			if (adj == NULL) {
+				ok = false;
+				break;
+			}
+			if (cauda == NULL) novo->proxAdj = adj;
+			else cauda->next = adj;
+			cauda = adj;
+		}
+		if (ultimo == NULL) g->inicioGrafo = novo;
+		else ultimo->proxVertice = novo;
+		ultimo = novo;
+		RegistaVerticeIndice(g, novo);
+	}
+	free(existe);
+
+	if (!ok) {
+		DestroiGrafo(g);
+		return NULL;
+	}
+	return g;
+}
+
+
+/**
+ * @brief Guarda um snapshot CSR num ficheiro no formato descrito por CabecalhoGrafoCSR.
+ *
+ * O ficheiro tem um cabealho com magia e verso, seguido dos destinos, dos pesos, dos
+ * offsets e dos ids, contguos, de forma a poder ser aberto com MapeiaGrafoCSR sem ser lido.
+ * S  guardado um offset por vrtice existente, pelo que um id grande e isolado no aumenta
+ * o ficheiro.
+ *
+ * @param csr Apontador para o snapshot a guardar.
+ * @param fileName Nome do ficheiro a criar.
+ * @return true se o ficheiro foi escrito, false caso contrrio (tambm se houver arestas a
+ * sair de um id que no est na lista de vrtices).
+ */
+bool GuardaGrafoCSR(GrafoCSR* csr, char fileName[]) {
+	if (csr == NULL || fileName == NULL) return false;
+
+	int* offsets = ReduzOffsets(csr->inicioAdj, csr->ids, csr->numIds, csr->numArestas);
+	if (offsets == NULL) return false;
+
+	CabecalhoGrafoCSR cab;
+	memset(&cab, 0, sizeof(cab));
+	memcpy(cab.magia, "GCSR", 4);
+	cab.versao = VERSAOGRAFOCSR;
+	cab.numVertices = csr->numVertices;
+	cab.numArestas = csr->numArestas;
+	cab.numIds = csr->numIds;
+	cab.posDestinos = (long long)sizeof(cab);
+	cab.posPesos = cab.posDestinos + (long long)csr->numArestas * (long long)sizeof(int);
+	cab.posInicioAdj = cab.posPesos + (long long)csr->numArestas * (long long)sizeof(int);
+	cab.posIds = cab.posInicioAdj + ((long long)csr->numIds + 1) * (long long)sizeof(int);
+
+	FILE* fp = fopen(fileName, "wb");
+	if (fp == NULL) {
+		free(offsets);
+		return false;
+	}
+
+	size_t numArestas = (size_t)csr->numArestas;
+	size_t numIds = (size_t)csr->numIds;
+	bool ok = (fwrite(&cab, sizeof(cab), 1, fp) == 1)
+		&& (fwrite(csr->destinos, sizeof(int), numArestas, fp) == numArestas)
+		&& (fwrite(csr->pesos, sizeof(int), numArestas, fp) == numArestas)
+		&& (fwrite(offsets, sizeof(int), numIds + 1, fp) == numIds + 1)
+		&& (fwrite(csr->ids, sizeof(int), numIds, fp) == numIds);
+	free(offsets);
+
+	if (fclose(fp) != 0) ok = false;
+	if (!ok) remove(fileName);
+	return ok;
+}
+
+
+/**
+ * @brief Abre um ficheiro CSR mapeando-o em memria, sem o ler nem copiar.
+ *
+ * Os vetores do snapshot devolvido apontam diretamente para o ficheiro mapeado; s os offsets
+ * so copiados, expandidos para um por id, quando os ids dos vrtices no so 0 a n-1. Antes
+ * de o snapshot ser devolvido, o ficheiro  todo validado, em O(V + E): o cabealho (magia,
+ * verso, e se as seces cabem no ficheiro), os ids (crescentes e dentro do espao de ids),
+ * os offsets (crescentes, de 0 a numArestas) e os destinos (ids vlidos), pelo que as procuras
+ * no precisam de verificar os ndices que leem. O snapshot  s de leitura e deve ser
+ * libertado com DestroiGrafoCSR, que desfaz o mapeamento.
+ *
+ * @param fileName Nome do ficheiro CSR (escrito por GuardaGrafoCSR ou ConverteMatrizParaCSR).
+ * @return Um apontador para o snapshot CSR, ou NULL se o ficheiro no existir ou for invlido.
+ */
+GrafoCSR* MapeiaGrafoCSR(char fileName[]) {
+	FicheiroMapeado* mapa = (FicheiroMapeado*)malloc(sizeof(FicheiroMapeado));
+	GrafoCSR* csr = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+	if (mapa == NULL || csr == NULL || !MapeiaFicheiro(fileName, mapa)) {
+		free(mapa);
+		free(csr);
+		return NULL;
+	}
+
+	CabecalhoGrafoCSR cab;
+	bool ok = (mapa->tamanho >= sizeof(cab));
+	if (ok) {
+		memcpy(&cab, mapa->dados, sizeof(cab));
+		ok = (memcmp(cab.magia, "GCSR", 4) == 0 && cab.versao == VERSAOGRAFOCSR
+			&& cab.numVertices >= 0 && cab.numArestas >= 0);
+	}
+	if (ok) {
+		// Cada seco tem de estar alinhada e dentro do ficheiro
+		long long tamanho = (long long)mapa->tamanho;
+		long long posicoes[4] = { cab.posDestinos, cab.posPesos, cab.posInicioAdj, cab.posIds };
+		long long tamanhos[4] = { (long long)cab.numArestas * (long long)sizeof(int),
+			(long long)cab.numArestas * (long long)sizeof(int),
+			((long long)cab.numIds + 1) * (long long)sizeof(int),
+			(long long)cab.numIds * (long long)sizeof(int) };
+		ok = (cab.numIds >= 0 && cab.numIds <= cab.numVertices);
+		for (int i = 0; i < 4 && ok; i++) {
+			ok = (posicoes[i] >= (long long)sizeof(cab) && posicoes[i] % sizeof(int) == 0
+				&& posicoes[i] <= tamanho && tamanhos[i] <= tamanho - posicoes[i]);
+		}
+	}
+	const int* offsets = NULL;
+	if (ok) {
+		csr->numVertices = cab.numVertices;
+		csr->numArestas = cab.numArestas;
+		csr->numIds = cab.numIds;
+		csr->destinos = (int*)(mapa->dados + cab.posDestinos);
+		csr->pesos = (int*)(mapa->dados + cab.posPesos);
+		csr->ids = (int*)(mapa->dados + cab.posIds);
+		csr->ficheiro = mapa;
+		csr->offsetsAlocados = false;
+		offsets = (const int*)(mapa->dados + cab.posInicioAdj);
+		ok = IdsValidos(csr->ids, cab.numIds, cab.numVertices) && offsets[0] == 0 && offsets[cab.numIds] == cab.numArestas;
+	}
+	for (int k = 0; ok && k < cab.numIds; k++) {
+		ok = (offsets[k] <= offsets[k + 1]);
+	}
+	for (int a = 0; ok && a < cab.numArestas; a++) {
+		ok = (csr->destinos[a] >= 0 && csr->destinos[a] < cab.numVertices);
+	}
+	if (ok) {
+		// Com todos os ids de 0 a n-1 os offsets j esto indexados por id
+		if (cab.numIds == cab.numVertices) {
+			csr->inicioAdj = (int*)offsets;
+		}
+		else {
+			csr->inicioAdj = ExpandeOffsets(offsets, csr->ids, cab.numIds, cab.numVertices);
+			csr->offsetsAlocados = true;
+			ok = (csr->inicioAdj != NULL);
+		}
+	}
+	if (!ok) {
+		DesmapeiaFicheiro(mapa);
+		free(mapa);
+		free(csr);
+		return NULL;
+	}
+	return csr;
+}
+
+
+/**
+ * @brief Procura em profundidade recursiva sobre um snapshot CSR.
+ *
+ * Equivalente a ProcuraProfundidadeRec, mas as adjacncias de cada vrtice so lidas
+ * de um intervalo contguo do vetor de destinos, sem procurar o vrtice na lista.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice atual da procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitado Array de booleanos que indica se um vrtice foi visitado.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param indice ndice do prximo elemento no caminho.
+ * @param somaCaminhos Apontador para a varivel que acumula a soma dos caminhos.
+ * @return Apontador para o snapshot CSR.
+ */
+GrafoCSR* ProcuraProfundidadeCSRRec(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos) {
+	visitado[origem] = true;
+	caminho[indice] = origem;
+	indice++;
+
+	if (origem == destino) {
+		for (int i = 0; i < indice; i++) {
+			printf("%d ", caminho[i]);
+		}
+		printf("\n");
+
+		int soma = 0;
+		for (int i = 0; i < indice; i++) {
+			soma += caminho[i];
+		}
+		*somaCaminhos += soma;
+	}
+	else {
+		for (int a = csr->inicioAdj[origem]; a < csr->inicioAdj[origem + 1]; a++) {
+			if (!visitado[csr->destinos[a]]) {
+				ProcuraProfundidadeCSRRec(csr, csr->destinos[a], destino, visitado, caminho, indice, somaCaminhos);
+			}
+		}
+	}
+
+	visitado[origem] = false;
+	return csr;
+}
+
+
+/**
+ * @brief Realiza uma procura em profundidade sobre um snapshot CSR e calcula a soma dos caminhos.
+ *
+ * Mostra todos os caminhos entre origem e destino pela mesma ordem que ProcuraProfundidade.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param soma Apontador para a varivel que ir armazenar a soma dos valores dos vrtices nos caminhos encontrados.
+ * @return Apontador para o snapshot CSR, ou NULL se os parmetros forem invlidos.
+ */
+GrafoCSR* ProcuraProfundidadeCSR(GrafoCSR* csr, int origem, int destino, int* soma) {
+	*soma = 0;
+	int somaCaminhos = 0;
+	GrafoCSR* res = PercorreCaminhosCSR(csr, origem, destino, VisitanteMostraCaminho, &somaCaminhos);
+	*soma = somaCaminhos;
+	return res;
+}
+
+
+/**
+ * @brief Entrega a um visitante todos os caminhos entre dois vrtices de um snapshot CSR.
+ *
+ * Procura iterativa equivalente a ProcuraProfundidadeVisita: cada nvel da pilha guarda o
+ * vrtice e a posio da prxima aresta a explorar no vetor de destinos.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitante Funo chamada para cada caminho encontrado.
+ * @param contexto Apontador passado ao visitante.
+ * @return Apontador para o snapshot CSR, ou NULL se os parmetros forem invlidos.
+ */
+GrafoCSR* PercorreCaminhosCSR(GrafoCSR* csr, int origem, int destino, VisitanteCaminho visitante, void* contexto) {
+	if (csr == NULL || visitante == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return NULL;
+	}
+
+	int n = csr->numVertices;
+	bool* visitado = (bool*)calloc(n, sizeof(bool));
+	int* caminho = (int*)malloc(n * sizeof(int));
+	int* cursor = (int*)malloc(n * sizeof(int));
+	int* somas = (int*)malloc(n * sizeof(int));
+	if (visitado == NULL || caminho == NULL || cursor == NULL || somas == NULL) {
+		free(visitado);
+		free(caminho);
+		free(cursor);
+		free(somas);
+		return NULL;
+	}
+
+	int topo = 0;
+	int v = origem;
+	int soma = 0;
+	while (true) {
+		visitado[v] = true;
+		caminho[topo] = v;
+
+		if (v == destino) {
+			if (!visitante(caminho, topo + 1, soma, contexto)) break;
+			visitado[v] = false;
+			topo--;
+		}
+		else {
+			cursor[topo] = csr->inicioAdj[v];
+			somas[topo] = soma;
+		}
+
+		v = -1;
+		while (topo >= 0) {
+			int u = caminho[topo];
+			int a = cursor[topo];
+			while (a < csr->inicioAdj[u + 1] && visitado[csr->destinos[a]]) {
+				a++;
+			}
+			if (a < csr->inicioAdj[u + 1]) {
+				cursor[topo] = a + 1;
+				v = csr->destinos[a];
+				soma = somas[topo] + csr->pesos[a];
+				break;
+			}
+			visitado[u] = false;
+			topo--;
+		}
+		if (v < 0) break;
+		topo++;
+	}
+
+	free(visitado);
+	free(caminho);
+	free(cursor);
+	free(somas);
+	return csr;
+}
+
+
+/**
+ * @brief Procura em profundidade sobre um snapshot CSR pelo caminho de maior soma de pesos.
+ *
+ * Ao contrrio de DFSrec, o peso do caminho  acumulado  medida que se desce na procura,
+ * em vez de ser recalculado a partir do incio em cada caminho completo.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice atual da procura.
+ * @param destino ID do vrtice de destino.
+ * @param visitado Array de booleanos indicando se um vrtice foi visitado durante o percurso.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param indice ndice atual no caminho.
+ * @param somaAtual Soma dos pesos das arestas do caminho at ao vrtice atual.
+ * @param somaMaxima Apontador para a varivel que armazena a maior soma de pesos encontrada.
+ * @param caminhoMaximo Array para armazenar o caminho correspondente  maior soma encontrada.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho mximo.
+ * @return Apontador para o snapshot CSR.
+ */
+GrafoCSR* DFSrecCSR(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int somaAtual, int* somaMaxima, int* caminhoMaximo, int* tamanhoMaximo) {
+	visitado[origem] = true;
+	caminho[indice] = origem;
+	indice++;
+
+	if (origem == destino) {
+		if (somaAtual > *somaMaxima) {
+			*somaMaxima = somaAtual;
+			for (int i = 0; i < indice; i++) {
+				caminhoMaximo[i] = caminho[i];
+			}
+			*tamanhoMaximo = indice;
+		}
+	}
+	else {
+		for (int a = csr->inicioAdj[origem]; a < csr->inicioAdj[origem + 1]; a++) {
+			if (!visitado[csr->destinos[a]]) {
+				DFSrecCSR(csr, csr->destinos[a], destino, visitado, caminho, indice, somaAtual + csr->pesos[a], somaMaxima, caminhoMaximo, tamanhoMaximo);
+			}
+		}
+	}
+
+	visitado[origem] = false;
+	return csr;
+}
+
+
+/**
+ * @brief Procura em profundidade com poda (branch-and-bound) pelo caminho de maior soma de pesos.
+ *
+ * Mantm a melhor soma encontrada at ao momento e no desce num ramo quando a soma acumulada
+ * mais um limite superior do ganho restante no a consegue ultrapassar. O limite  a soma,
+ * para cada vrtice ainda por visitar (exceto o destino), do maior peso das suas arestas de sada.
+ * Como s se poda quando nenhum caminho do ramo pode ser estritamente melhor, o resultado
+ * (soma e caminho)  igual ao da procura exaustiva.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice atual da procura.
+ * @param destino ID do vrtice de destino.
+ * @param visitado Array de booleanos indicando se um vrtice foi visitado durante o percurso.
+ * @param caminho Array para armazenar o caminho atual.
+ * @param indice ndice atual no caminho.
+ * @param somaAtual Soma dos pesos das arestas do caminho at ao vrtice atual.
+ * @param livre Soma de maxSaida dos vrtices por visitar, diferentes do destino.
+ * @param maxSaida Maior peso (no negativo) das arestas de sada de cada vrtice.
+ * @param somaMaxima Apontador para a melhor soma encontrada.
+ * @param caminhoMaximo Array para armazenar o caminho correspondente  maior soma encontrada.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho mximo.
+ * @return Apontador para o snapshot CSR.
+ */
+GrafoCSR* DFSPodaCSR(GrafoCSR* csr, int origem, int destino, bool* visitado, int* caminho, int indice, int somaAtual, long long livre, int* maxSaida, int* somaMaxima, int* caminhoMaximo, int* tamanhoMaximo) {
+	visitado[origem] = true;
+	caminho[indice] = origem;
+	indice++;
+
+	if (origem == destino) {
+		if (somaAtual > *somaMaxima) {
+			*somaMaxima = somaAtual;
+			for (int i = 0; i < indice; i++) {
+				caminhoMaximo[i] = caminho[i];
+			}
+			*tamanhoMaximo = indice;
+		}
+	}
+	else {
+		livre -= maxSaida[origem]; // o vrtice atual deixa de contar para o ganho restante
+		for (int a = csr->inicioAdj[origem]; a < csr->inicioAdj[origem + 1]; a++) {
+			int v = csr->destinos[a];
+			if (visitado[v]) continue;
+
+			// Limite superior de qualquer caminho que continue por esta aresta
+			long long limite = (long long)somaAtual + csr->pesos[a];
+			if (v != destino) limite += livre;
+			if (limite > *somaMaxima) {
+				DFSPodaCSR(csr, v, destino, visitado, caminho, indice, somaAtual + csr->pesos[a], livre, maxSaida, somaMaxima, caminhoMaximo, tamanhoMaximo);
+			}
+		}
+	}
+
+	visitado[origem] = false;
+	return csr;
+}
+
+
+/**
+ * @brief Estima a memria necessria ao motor Held-Karp.
+ *
+ * A tabela tem um estado por cada par (subconjunto dos vrtices exceto a origem, ltimo vrtice).
+ * HeldKarpCSR compara este valor com o oramento antes de reservar a tabela.
+ *
+ * @param numVertices Nmero de vrtices da tabela (os que podem estar no caminho).
+ * @return O nmero de bytes necessrios, ou 0 se numVertices exceder MAXVERTICESHELDKARP.
+ */
+size_t MemoriaHeldKarp(int numVertices) {
+	if (numVertices <= 0 || numVertices > MAXVERTICESHELDKARP) return 0;
+	size_t estados = ((size_t)1 << (numVertices - 1)) * (size_t)numVertices;
+	return estados * sizeof(int) + 3 * (size_t)numVertices * sizeof(int) + sizeof(TabelaHeldKarp);
+}
+
+
+/**
+ * @brief Calcula por programao dinmica os caminhos de maior soma a partir de uma origem.
+ *
+ * Para cada subconjunto de vrtices visitados e cada ltimo vrtice guarda a maior soma de
+ * um caminho simples que parte da origem, visita exatamente esse subconjunto e termina nesse vrtice.
+ * Os subconjuntos so percorridos por ordem crescente, pelo que cada estado j est final quando
+ *  expandido. Uma nica passagem responde a todos os destinos. A tabela s tem os vrtices
+ * ativos (por exemplo, os que AlcancaveisCSR marca como teis), numerados de forma compacta, e
+ * s  reservada se MemoriaHeldKarp do nmero de vrtices ativos couber no oramento.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param ativo Array com csr->numVertices posies, true para os vrtices que podem estar no
+ * caminho (NULL para todos); a origem tem de ser ativa.
+ * @param orcamento Memria mxima da tabela, em bytes (0 para ORCAMENTOHELDKARP).
+ * @return Um apontador para a tabela calculada, ou NULL se a tabela exceder o oramento ou
+ * MAXVERTICESHELDKARP vrtices, ou se a alocao falhar.
+ */
+TabelaHeldKarp* HeldKarpCSR(GrafoCSR* csr, int origem, const bool* ativo, size_t orcamento) {
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices) return NULL;
+	if (ativo != NULL && !ativo[origem]) return NULL;
+	if (orcamento == 0) orcamento = ORCAMENTOHELDKARP;
+
+	// Dimenso da tabela: s os vrtices ativos; a posio de cada id fica tambm no oramento
+	int n = 0;
+	for (int v = 0; v < csr->numVertices; v++) {
+		if (ativo == NULL || ativo[v]) n++;
+	}
+	size_t memoria = MemoriaHeldKarp(n);
+	if (memoria == 0 || memoria > orcamento || (size_t)csr->numVertices * sizeof(int) > orcamento - memoria) return NULL;
+	size_t numMascaras = (size_t)1 << (n - 1);
+
+	TabelaHeldKarp* tabela = (TabelaHeldKarp*)calloc(1, sizeof(TabelaHeldKarp));
+	if (tabela == NULL) return NULL;
+	tabela->numVertices = n;
+	tabela->vertices = (int*)malloc(n * sizeof(int));
+	tabela->posicao = (int*)malloc((size_t)csr->numVertices * sizeof(int));
+	tabela->somas = (int*)malloc(numMascaras * n * sizeof(int));
+	tabela->melhor = (int*)malloc(n * sizeof(int));
+	tabela->mascaraMelhor = (int*)malloc(n * sizeof(int));
+	if (tabela->vertices == NULL || tabela->posicao == NULL || tabela->somas == NULL || tabela->melhor == NULL || tabela->mascaraMelhor == NULL) {
+		DestroiTabelaHeldKarp(tabela);
+		return NULL;
+	}
+
+	int k = 0;
+	for (int v = 0; v < csr->numVertices; v++) {
+		if (ativo == NULL || ativo[v]) {
+			tabela->posicao[v] = k;
+			tabela->vertices[k++] = v;
+		}
+		else {
+			tabela->posicao[v] = -1;
+		}
+	}
+	origem = tabela->posicao[origem];
+	tabela->origem = origem;
+
+	for (size_t i = 0; i < numMascaras * n; i++) {
+		tabela->somas[i] = INT_MIN;
+	}
+	for (int v = 0; v < n; v++) {
+		tabela->melhor[v] = INT_MIN;
+		tabela->mascaraMelhor[v] = 0;
+	}
+	tabela->somas[origem] = 0; // subconjunto vazio, caminho s com a origem
+	tabela->melhor[origem] = 0;
+
+	for (size_t mascara = 0; mascara < numMascaras; mascara++) {
+		int* linha = tabela->somas + mascara * n;
+		for (int u = 0; u < n; u++) {
+			if (linha[u] == INT_MIN) continue;
+
+			int idU = tabela->vertices[u];
+			for (int a = csr->inicioAdj[idU]; a < csr->inicioAdj[idU + 1]; a++) {
+				int v = tabela->posicao[csr->destinos[a]];
+				if (v < 0 || v == origem) continue;
+				size_t bit = (size_t)1 << (v < origem ? v : v - 1);
+				if (mascara & bit) continue;
+
+				size_t nova = mascara | bit;
+				int soma = linha[u] + csr->pesos[a];
+				if (soma > tabela->somas[nova * n + v]) {
+					tabela->somas[nova * n + v] = soma;
+					if (soma > tabela->melhor[v]) {
+						tabela->melhor[v] = soma;
+						tabela->mascaraMelhor[v] = (int)nova;
+					}
+				}
+			}
+		}
+	}
+
+	return tabela;
+}
+
+
+/**
+ * @brief Reconstri, a partir de uma tabela Held-Karp, o caminho de maior soma at um destino.
+ *
+ * O caminho  reconstrudo do destino para a origem, procurando em cada passo o vrtice
+ * anterior cujo estado mais o peso da aresta reproduz a soma do estado atual.
+ *
+ * @param tabela Apontador para a tabela calculada por HeldKarpCSR.
+ * @param csr Apontador para o snapshot CSR usado para calcular a tabela.
+ * @param destino ID do vrtice de destino.
+ * @param caminho Array com pelo menos numVertices posies onde fica o caminho (ids do snapshot).
+ * @param tamanho Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima, ou 0 se no existir caminho com soma positiva.
+ */
+int CaminhoHeldKarp(TabelaHeldKarp* tabela, GrafoCSR* csr, int destino, int* caminho, int* tamanho) {
+	*tamanho = 0;
+	if (tabela == NULL || csr == NULL || destino < 0 || destino >= csr->numVertices) return 0;
+	destino = tabela->posicao[destino];
+	if (destino < 0 || tabela->melhor[destino] == INT_MIN || tabela->melhor[destino] <= 0) return 0;
+
+	int n = tabela->numVertices;
+	int origem = tabela->origem;
+	size_t mascara = (size_t)tabela->mascaraMelhor[destino];
+	int v = destino;
+	int k = ContaBits(mascara); // vrtices do caminho alm da origem
+
+	caminho[k] = tabela->vertices[v];
+	while (mascara != 0) {
+		size_t anterior = mascara & ~((size_t)1 << (v < origem ? v : v - 1));
+		int alvo = tabela->somas[mascara * n + v];
+		int u = -1;
+		for (int w = 0; w < n && u < 0; w++) {
+			int somaW = tabela->somas[anterior * n + w];
+			if (somaW == INT_MIN) continue;
+			int idW = tabela->vertices[w];
+			for (int a = csr->inicioAdj[idW]; a < csr->inicioAdj[idW + 1]; a++) {
+				if (csr->destinos[a] == tabela->vertices[v] && somaW + csr->pesos[a] == alvo) {
+					u = w;
+					break;
+				}
+			}
+		}
+		if (u < 0) return 0; // tabela inconsistente com o snapshot
+		mascara = anterior;
+		v = u;
+		caminho[--k] = tabela->vertices[v];
+	}
+
+	*tamanho = ContaBits((size_t)tabela->mascaraMelhor[destino]) + 1;
+	return tabela->melhor[destino];
+}
+
+
+/**
+ * @brief Liberta a memria de uma tabela Held-Karp.
+ *
+ * @param tabela Apontador para a tabela a destruir (pode ser NULL).
+ */
+void DestroiTabelaHeldKarp(TabelaHeldKarp* tabela) {
+	if (tabela == NULL) return;
+	free(tabela->vertices);
+	free(tabela->posicao);
+	free(tabela->somas);
+	free(tabela->melhor);
+	free(tabela->mascaraMelhor);
+	free(tabela);
+}
+
+
+/**
+ * @brief Calcula o caminho de maior soma de pesos entre dois vrtices de um snapshot CSR.
+ *
+ * Como em encontrarCaminhoMaiorSoma, s so considerados caminhos com soma positiva e,
+ * em caso de empate, os motores de procura em profundidade ficam com o primeiro caminho encontrado.
+ * Os motores Held-Karp, por componentes e DAG devolvem a mesma soma, mas podem escolher outro
+ * caminho entre os empatados. O motor Held-Karp s usa os vrtices que podem estar no caminho;
+ * se, mesmo assim, a tabela exceder ORCAMENTOHELDKARP bytes (ver MemoriaHeldKarp) ou
+ * MAXVERTICESHELDKARP vrtices,  usada a procura com poda. Com MOTOR_AUTOMATICO, o motor  escolhido como em encontrarCaminhoMaiorSoma. Antes da procura so excludos os vrtices que no podem estar num caminho at ao destino e, se este no for
+ * alcanvel a partir da origem, a funo termina logo.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param motor Algoritmo a utilizar.
+ * @param caminhoMaximo Array com pelo menos csr->numVertices posies onde fica o caminho.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima encontrada, ou 0 se no existir caminho com soma positiva.
+ */
+int CaminhoMaiorSomaCSR(GrafoCSR* csr, int origem, int destino, MotorCaminho motor, int* caminhoMaximo, int* tamanhoMaximo) {
+	*tamanhoMaximo = 0;
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return 0;
+	}
+	if (motor == MOTOR_AUTOMATICO) motor = EscolheMotorCaminho(csr, origem, destino);
+
+	bool* visitado = (bool*)calloc(csr->numVertices, sizeof(bool));
+	int* caminho = (int*)malloc(sizeof(int) * csr->numVertices);
+	bool* util = (bool*)malloc(sizeof(bool) * csr->numVertices);
+	if (visitado == NULL || caminho == NULL || util == NULL) {
+		free(visitado);
+		free(caminho);
+		free(util);
+		return 0;
+	}
+
+	// Os vrtices que no levam ao destino ficam marcados como visitados; sem caminho, no h procura
+	int alcanca = AlcancaveisCSR(csr, origem, destino, util);
+	if (alcanca == 1) {
+		for (int v = 0; v < csr->numVertices; v++) {
+			visitado[v] = !util[v];
+		}
+	}
+	if (alcanca == 0) {
+		free(visitado);
+		free(caminho);
+		free(util);
+		return 0;
+	}
+
+	int somaMaxima = 0;
+	if (motor == MOTOR_HELDKARP) {
+		// Se a tabela dos vrtices teis no couber no oramento, recorre  procura com poda
+		TabelaHeldKarp* tabela = HeldKarpCSR(csr, origem, (alcanca == 1) ? util : NULL, 0);
+		if (tabela != NULL) {
+			somaMaxima = CaminhoHeldKarp(tabela, csr, destino, caminhoMaximo, tamanhoMaximo);
+			DestroiTabelaHeldKarp(tabela);
+		}
+		else {
+			motor = MOTOR_PODA;
+		}
+	}
+
+	if (motor == MOTOR_PODA) {
+		int* maxSaida = (int*)calloc(csr->numVertices, sizeof(int));
+		if (maxSaida != NULL) {
+			long long livre = 0;
+			for (int v = 0; v < csr->numVertices; v++) {
+				for (int a = csr->inicioAdj[v]; a < csr->inicioAdj[v + 1]; a++) {
+					if (csr->pesos[a] > maxSaida[v]) maxSaida[v] = csr->pesos[a];
+				}
+				if (v != destino && !visitado[v]) livre += maxSaida[v];
+			}
+			DFSPodaCSR(csr, origem, destino, visitado, caminho, 0, 0, livre, maxSaida, &somaMaxima, caminhoMaximo, tamanhoMaximo);
+			free(maxSaida);
+		}
+	}
+	else if (motor == MOTOR_PARALELO) {
+		somaMaxima = CaminhoMaiorSomaParaleloCSR(csr, origem, destino, 0, caminhoMaximo, tamanhoMaximo);
+	}
+	else if (motor == MOTOR_DAG) {
+		somaMaxima = CaminhoMaiorSomaDAGCSR(csr, origem, destino, caminhoMaximo, tamanhoMaximo);
+	}
+	else if (motor == MOTOR_COMPONENTES) {
+		somaMaxima = CaminhoMaiorSomaComponentesCSR(csr, origem, destino, 0, caminhoMaximo, tamanhoMaximo);
+	}
+	else if (motor == MOTOR_EXAUSTIVO) {
+		DFSrecCSR(csr, origem, destino, visitado, caminho, 0, 0, &somaMaxima, caminhoMaximo, tamanhoMaximo);
+	}
+
+	free(visitado);
+	free(caminho);
+	free(util);
+	return somaMaxima;
+}
+
+
+/**
+ * @brief Encontra o caminho de maior soma de pesos num snapshot CSR e mostra o resultado.
+ *
+ * Produz a mesma sada que encontrarCaminhoMaiorSoma sobre o grafo original, sem a linha do
+ * algoritmo utilizado.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param motor Algoritmo a utilizar.
+ */
+void encontrarCaminhoMaiorSomaCSR(GrafoCSR* csr, int origem, int destino, MotorCaminho motor) {
+	if (csr == NULL) return;
+
+	int* caminhoMaximo = (int*)malloc(sizeof(int) * (csr->numVertices + 1));
+	if (caminhoMaximo == NULL) return;
+
+	int tamanhoMaximo = 0;
+	int somaMaxima = CaminhoMaiorSomaCSR(csr, origem, destino, motor, caminhoMaximo, &tamanhoMaximo);
+
+	//Mostra soma mxima e o caminho correspondente
+	printf("Soma mxima: %d\n", somaMaxima);
+	printf("Caminho correspondente: ");
+	for (int i = 0; i < tamanhoMaximo; i++) {
+		printf("%d ", caminhoMaximo[i]);
+	}
+	printf("\n");
+
+	free(caminhoMaximo);
+}
+
+
+/**
+ * @brief Encontra o caminho de maior soma de pesos no grafo com o algoritmo indicado.
+ *
+ * Congela o grafo num snapshot CSR, executa o motor pedido e mostra o resultado
+ * no mesmo formato que encontrarCaminhoMaiorSoma. Com a cache de caminhos ativa, o resultado
+ * de uma consulta repetida na mesma verso do grafo  reutilizado.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param motor Algoritmo a utilizar.
+ */
+void encontrarCaminhoMaiorSomaModo(Grafo* g, int origem, int destino, MotorCaminho motor) {
+	if (g == NULL) return;
+	if (g->cache == NULL) {
+		GrafoCSR* csr = CongelaGrafo(g);
+		if (csr == NULL) return;
+		encontrarCaminhoMaiorSomaCSR(csr, origem, destino, motor);
+		DestroiGrafoCSR(csr);
+		return;
+	}
+
+	EntradaCache* e = UsaEntradaCache(g, origem, destino, motor);
+	if (e != NULL) {
+		MostraCaminhoMaiorSoma(e->soma, e->caminho, e->tamanho);
+		return;
+	}
+
+	GrafoCSR* csr = CongelaGrafo(g);
+	if (csr == NULL) return;
+	int* caminho = (int*)malloc(sizeof(int) * ((size_t)csr->numVertices + 1));
+	if (caminho != NULL) {
+		// Guarda o motor escolhido, que encontrarCaminhoMaiorSoma mostra ao reutilizar o resultado
+		MotorCaminho usado = (motor == MOTOR_AUTOMATICO) ? EscolheMotorCaminho(csr, origem, destino) : motor;
+		int tamanho = 0;
+		int somaMaxima = CaminhoMaiorSomaCSR(csr, origem, destino, usado, caminho, &tamanho);
+		GuardaEntradaCache(g, origem, destino, motor, usado, caminho, tamanho, somaMaxima);
+		MostraCaminhoMaiorSoma(somaMaxima, caminho, tamanho);
+		free(caminho);
+	}
+	DestroiGrafoCSR(csr);
+}
+
+#pragma endregion
+
+#pragma region Paralelo
+
+/*
+ * Procura em profundidade paralela. A rvore de procura  dividida em tarefas, cada uma um
+ * prefixo de caminho a partir da origem, geradas por ordem da procura sequencial. Cada fio
+ * tem a sua fila de tarefas (deque): retira do fundo da sua e, quando esta fica vazia,
+ * rouba do topo da fila de outro fio. A melhor soma  partilhada atravs de um inteiro
+ * atmico para que todos os fios podem com as descobertas dos outros. Os empates so
+ * resolvidos pelo ndice da tarefa, pelo que o resultado  igual ao da procura sequencial.
+ */
+
+typedef struct FilaTarefas {
+	Trinco trinco;
+	int* itens;		//ndices das tarefas
+	int inicio;		//topo, de onde os outros fios roubam
+	int fim;		//fundo, de onde o dono retira
+}FilaTarefas;
+
+
+typedef struct ProcuraParalela {
+	GrafoCSR* csr;
+	int destino;
+	bool soContagem;		//true para enumerar caminhos, false para a maior soma
+	int* maxSaida;
+	long long livreTotal;
+	int numTarefas;
+	int* tarefaInicio;		//posio do prefixo de cada tarefa em prefixos
+	int* tarefaTamanho;
+	int* tarefaSoma;
+	int* prefixos;
+	int numFios;
+	FilaTarefas* filas;
+	volatile int melhorGlobal;
+}ProcuraParalela;
+
+
+typedef struct TrabalhadorDFS {
+	ProcuraParalela* procura;
+	int indiceFio;
+	bool* visitado;
+	int* caminho;
+	int tarefaAtual;
+	int melhorSoma;
+	int melhorTarefa;		//-1 enquanto no houver caminho com soma positiva
+	int* melhorCaminho;
+	int melhorTamanho;
+	long long numCaminhos;
+	long long somaCaminhos;
+}TrabalhadorDFS;
+
+
+/**
+ * @brief Gera as tarefas da procura paralela expandindo a rvore de procura nvel a nvel.
+ *
+ * Cada expanso substitui cada prefixo pelos seus filhos, pela ordem das adjacncias, o que
+ * mantm as tarefas na ordem da procura sequencial. Os prefixos que j terminam no destino
+ * ficam como esto. Pra quando h tarefas suficientes ou quando a prxima expanso excederia MAXTAREFAS.
+ *
+ * @param p Apontador para o estado da procura.
+ * @param origem ID do vrtice de origem.
+ * @param alvo Nmero de tarefas pretendido.
+ * @return true se as tarefas foram geradas, false se a alocao falhar.
+ */
+static bool GeraTarefas(ProcuraParalela* p, int origem, int alvo) {
+	GrafoCSR* csr = p->csr;
+	int numTarefas = 1;
+	int* inicio = (int*)malloc(sizeof(int));
+	int* tamanho = (int*)malloc(sizeof(int));
+	int* soma = (int*)malloc(sizeof(int));
+	int* prefixos = (int*)malloc(sizeof(int));
+	if (inicio == NULL || tamanho == NULL || soma == NULL || prefixos == NULL) {
+		free(inicio); free(tamanho); free(soma); free(prefixos);
+		return false;
+	}
+	inicio[0] = 0;
+	tamanho[0] = 1;
+	soma[0] = 0;
+	prefixos[0] = origem;
+
+	while (numTarefas < alvo) {
+		// Conta as tarefas e o espao de prefixos do prximo nvel
+		long long novas = 0;
+		long long espaco = 0;
+		bool expandiu = false;
+		for (int t = 0; t < numTarefas; t++) {
+			int* pre = prefixos + inicio[t];
+			int ultimo = pre[tamanho[t] - 1];
+			if (ultimo == p->destino) {
+				novas++;
+				espaco += tamanho[t];
+				continue;
+			}
+			for (int a = csr->inicioAdj[ultimo]; a < csr->inicioAdj[ultimo + 1]; a++) {
+				bool repetido = false;
+				for (int i = 0; i < tamanho[t] && !repetido; i++) {
+					repetido = (pre[i] == csr->destinos[a]);
+				}
+				if (!repetido) {
+					novas++;
+					espaco += tamanho[t] + 1;
+					expandiu = true;
+				}
+			}
+		}
+		if (!expandiu || novas > MAXTAREFAS) break;
+
+		int* nInicio = (int*)malloc(novas * sizeof(int));
+		int* nTamanho = (int*)malloc(novas * sizeof(int));
+		int* nSoma = (int*)malloc(novas * sizeof(int));
+		int* nPrefixos = (int*)malloc((espaco + 1) * sizeof(int));
+		if (nInicio == NULL || nTamanho == NULL || nSoma == NULL || nPrefixos == NULL) {
+			free(nInicio); free(nTamanho); free(nSoma); free(nPrefixos);
+			break; // fica com o nvel atual
+		}
+
+		int n = 0;
+		int pos = 0;
+		for (int t = 0; t < numTarefas; t++) {
+			int* pre = prefixos + inicio[t];
+			int ultimo = pre[tamanho[t] - 1];
+			if (ultimo == p->destino) {
+				nInicio[n] = pos;
+				nTamanho[n] = tamanho[t];
+				nSoma[n] = soma[t];
+				memcpy(nPrefixos + pos, pre, tamanho[t] * sizeof(int));
+				pos += tamanho[t];
+				n++;
+				continue;
+			}
+			for (int a = csr->inicioAdj[ultimo]; a < csr->inicioAdj[ultimo + 1]; a++) {
+				bool repetido = false;
+				for (int i = 0; i < tamanho[t] && !repetido; i++) {
+					repetido = (pre[i] == csr->destinos[a]);
+				}
+				if (repetido) continue;
+				nInicio[n] = pos;
+				nTamanho[n] = tamanho[t] + 1;
+				nSoma[n] = soma[t] + csr->pesos[a];
+				memcpy(nPrefixos + pos, pre, tamanho[t] * sizeof(int));
+				nPrefixos[pos + tamanho[t]] = csr->destinos[a];
+				pos += tamanho[t] + 1;
+				n++;
+			}
+		}
+
+		free(inicio); free(tamanho); free(soma); free(prefixos);
+		inicio = nInicio;
+		tamanho = nTamanho;
+		soma = nSoma;
+		prefixos = nPrefixos;
+		numTarefas = n;
+	}
+
+	p->numTarefas = numTarefas;
+	p->tarefaInicio = inicio;
+	p->tarefaTamanho = tamanho;
+	p->tarefaSoma = soma;
+	p->prefixos = prefixos;
+	return true;
+}
+
+
+/**
+ * @brief Indica se um ramo com o limite dado pode ser podado por um fio.
+ *
+ * Um ramo s  podado se no puder ter um caminho melhor do que o melhor do fio
+ * (considerando o desempate pelo ndice da tarefa) ou estritamente melhor do que o global.
+ */
+static bool PodeRamo(TrabalhadorDFS* t, long long limite) {
+	if (limite < t->melhorSoma) return true;
+	if (limite == t->melhorSoma && (t->melhorTarefa < 0 || t->tarefaAtual >= t->melhorTarefa)) return true;
+	return limite < LeAtomico(&t->procura->melhorGlobal);
+}
+
+
+/**
+ * @brief Procura em profundidade recursiva executada por um fio dentro de uma tarefa.
+ *
+ * @param t Apontador para o estado do fio.
+ * @param origem O vrtice atual da procura.
+ * @param indice ndice atual no caminho.
+ * @param somaAtual Soma dos pesos das arestas do caminho at ao vrtice atual.
+ * @param livre Soma de maxSaida dos vrtices por visitar, diferentes do destino.
+ */
+static void DFSParaleloRec(TrabalhadorDFS* t, int origem, int indice, int somaAtual, long long livre) {
+	ProcuraParalela* p = t->procura;
+	GrafoCSR* csr = p->csr;
+
+	t->visitado[origem] = true;
+	t->caminho[indice] = origem;
+	indice++;
+
+	if (origem == p->destino) {
+		if (p->soContagem) {
+			t->numCaminhos++;
+			for (int i = 0; i < indice; i++) {
+				t->somaCaminhos += t->caminho[i];
+			}
+		}
+		else if (somaAtual > t->melhorSoma || (somaAtual == t->melhorSoma && t->melhorTarefa >= 0 && t->tarefaAtual < t->melhorTarefa)) {
+			t->melhorSoma = somaAtual;
+			t->melhorTarefa = t->tarefaAtual;
+			memcpy(t->melhorCaminho, t->caminho, indice * sizeof(int));
+			t->melhorTamanho = indice;
+			MaximoAtomico(&p->melhorGlobal, somaAtual);
+		}
+	}
+	else {
+		livre -= p->maxSaida[origem];
+		for (int a = csr->inicioAdj[origem]; a < csr->inicioAdj[origem + 1]; a++) {
+			int v = csr->destinos[a];
+			if (t->visitado[v]) continue;
+			if (!p->soContagem) {
+				long long limite = (long long)somaAtual + csr->pesos[a];
+				if (v != p->destino) limite += livre;
+				if (PodeRamo(t, limite)) continue;
+			}
+			DFSParaleloRec(t, v, indice, somaAtual + csr->pesos[a], livre);
+		}
+	}
+
+	t->visitado[origem] = false;
+}
+
+
+/**
+ * @brief Retira a prxima tarefa de um fio: do fundo da sua fila ou, se vazia, roubada a outro fio.
+ *
+ * @return O ndice da tarefa, ou -1 se todas as filas estiverem vazias.
+ */
+static int ProximaTarefa(TrabalhadorDFS* t) {
+	ProcuraParalela* p = t->procura;
+
+	FilaTarefas* propria = &p->filas[t->indiceFio];
+	FechaTrinco(&propria->trinco);
+	int tarefa = (propria->fim > propria->inicio) ? propria->itens[--propria->fim] : -1;
+	AbreTrinco(&propria->trinco);
+	if (tarefa >= 0) return tarefa;
+
+	for (int k = 1; k < p->numFios; k++) {
+		FilaTarefas* vitima = &p->filas[(t->indiceFio + k) % p->numFios];
+		FechaTrinco(&vitima->trinco);
+		tarefa = (vitima->fim > vitima->inicio) ? vitima->itens[vitima->inicio++] : -1;
+		AbreTrinco(&vitima->trinco);
+		if (tarefa >= 0) return tarefa;
+	}
+	return -1;
+}
+
+
+/**
+ * @brief Ciclo de um fio da procura paralela: executa tarefas at no haver mais nenhuma.
+ */
+static void TrabalhaDFS(void* contexto) {
+	TrabalhadorDFS* t = (TrabalhadorDFS*)contexto;
+	ProcuraParalela* p = t->procura;
+
+	int tarefa;
+	while ((tarefa = ProximaTarefa(t)) >= 0) {
+		t->tarefaAtual = tarefa;
+		int* pre = p->prefixos + p->tarefaInicio[tarefa];
+		int tamanho = p->tarefaTamanho[tarefa];
+		int ultimo = pre[tamanho - 1];
+
+		// Reconstri o estado da procura no fim do prefixo
+		long long livre = p->livreTotal;
+		for (int i = 0; i < tamanho - 1; i++) {
+			t->visitado[pre[i]] = true;
+			t->caminho[i] = pre[i];
+			livre -= p->maxSaida[pre[i]];
+		}
+
+		long long limite = p->tarefaSoma[tarefa];
+		if (ultimo != p->destino) limite += livre;
+		if (p->soContagem || !PodeRamo(t, limite)) {
+			DFSParaleloRec(t, ultimo, tamanho - 1, p->tarefaSoma[tarefa], livre);
+		}
+
+		for (int i = 0; i < tamanho - 1; i++) {
+			t->visitado[pre[i]] = false;
+		}
+	}
+}
+
+
+/**
+ * @brief Prepara e executa uma procura paralela e liberta os recursos partilhados.
+ *
+ * @param p Apontador para o estado da procura, com csr, destino e soContagem preenchidos.
+ * @param origem ID do vrtice de origem.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @param trabalhadores Apontador onde fica o array de estados dos fios (a libertar com LibertaTrabalhadores).
+ * @return true se a procura foi executada, false se a alocao falhar.
+ */
+static bool ExecutaProcuraParalela(ProcuraParalela* p, int origem, int numFios, TrabalhadorDFS** trabalhadores) {
+	GrafoCSR* csr = p->csr;
+	int n = csr->numVertices;
+	if (numFios <= 0) numFios = NumeroProcessadores();
+
+	p->melhorGlobal = 0;
+	p->livreTotal = 0;
+	p->maxSaida = (int*)calloc(n, sizeof(int));
+	if (p->maxSaida == NULL) return false;
+	for (int v = 0; v < n; v++) {
+		for (int a = csr->inicioAdj[v]; a < csr->inicioAdj[v + 1]; a++) {
+			if (csr->pesos[a] > p->maxSaida[v]) p->maxSaida[v] = csr->pesos[a];
+		}
+		if (v != p->destino) p->livreTotal += p->maxSaida[v];
+	}
+
+	if (!GeraTarefas(p, origem, numFios * TAREFASPORFIO)) {
+		free(p->maxSaida);
+		return false;
+	}
+	if (numFios > p->numTarefas) numFios = p->numTarefas;
+	p->numFios = numFios;
+
+	// Reparte as tarefas em blocos contguos; o dono retira-as por ordem crescente
+	p->filas = (FilaTarefas*)calloc(numFios, sizeof(FilaTarefas));
+	TrabalhadorDFS* t = (TrabalhadorDFS*)calloc(numFios, sizeof(TrabalhadorDFS));
+	bool ok = (p->filas != NULL && t != NULL);
+	for (int f = 0; ok && f < numFios; f++) {
+		int primeira = (int)((long long)p->numTarefas * f / numFios);
+		int ultima = (int)((long long)p->numTarefas * (f + 1) / numFios);
+		FilaTarefas* fila = &p->filas[f];
+		fila->itens = (int*)malloc((ultima - primeira + 1) * sizeof(int));
+		t[f].visitado = (bool*)calloc(n, sizeof(bool));
+		t[f].caminho = (int*)malloc(n * sizeof(int));
+		t[f].melhorCaminho = (int*)malloc(n * sizeof(int));
+		if (fila->itens == NULL || t[f].visitado == NULL || t[f].caminho == NULL || t[f].melhorCaminho == NULL) {
+			ok = false;
+			break;
+		}
+		for (int k = ultima - 1; k >= primeira; k--) {
+			fila->itens[fila->fim++] = k;
+		}
+		IniciaTrinco(&fila->trinco);
+		t[f].procura = p;
+		t[f].indiceFio = f;
+		t[f].melhorTarefa = -1;
+	}
+
+	if (ok) {
+		ExecutaEmParalelo(numFios, TrabalhaDFS, t, sizeof(TrabalhadorDFS));
+	}
+
+	for (int f = 0; p->filas != NULL && f < numFios; f++) {
+		if (p->filas[f].itens != NULL) {
+			DestroiTrinco(&p->filas[f].trinco);
+			free(p->filas[f].itens);
+		}
+	}
+	free(p->filas);
+	free(p->maxSaida);
+	free(p->tarefaInicio);
+	free(p->tarefaTamanho);
+	free(p->tarefaSoma);
+	free(p->prefixos);
+
+	if (!ok && t != NULL) {
+		for (int f = 0; f < numFios; f++) {
+			free(t[f].visitado);
+			free(t[f].caminho);
+			free(t[f].melhorCaminho);
+		}
+		free(t);
+		t = NULL;
+	}
+	*trabalhadores = t;
+	return ok;
+}
+
+
+/**
+ * @brief Liberta os estados dos fios de uma procura paralela.
+ */
+static void LibertaTrabalhadores(TrabalhadorDFS* t, int numFios) {
+	if (t == NULL) return;
+	for (int f = 0; f < numFios; f++) {
+		free(t[f].visitado);
+		free(t[f].caminho);
+		free(t[f].melhorCaminho);
+	}
+	free(t);
+}
+
+
+/**
+ * @brief Enumera em paralelo todos os caminhos entre dois vrtices de um snapshot CSR.
+ *
+ * Verso paralela de ProcuraProfundidadeCSR: em vez de mostrar cada caminho, conta-os e
+ * acumula a soma dos valores dos vrtices de todos os caminhos encontrados. Como o nmero
+ * de caminhos cresce exponencialmente, a soma  devolvida em long long.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @param soma Apontador para a soma dos valores dos vrtices nos caminhos encontrados.
+ * @param numCaminhos Apontador para o nmero de caminhos encontrados (pode ser NULL).
+ * @return Apontador para o snapshot CSR, ou NULL se os parmetros forem invlidos ou a alocao falhar.
+ */
+GrafoCSR* ProcuraProfundidadeParaleloCSR(GrafoCSR* csr, int origem, int destino, int numFios, long long* soma, long long* numCaminhos) {
+	*soma = 0;
+	if (numCaminhos != NULL) *numCaminhos = 0;
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return NULL;
+	}
+
+	ProcuraParalela p;
+	memset(&p, 0, sizeof(p));
+	p.csr = csr;
+	p.destino = destino;
+	p.soContagem = true;
+
+	TrabalhadorDFS* t;
+	if (!ExecutaProcuraParalela(&p, origem, numFios, &t)) return NULL;
+
+	long long total = 0;
+	long long caminhos = 0;
+	for (int f = 0; f < p.numFios; f++) {
+		total += t[f].somaCaminhos;
+		caminhos += t[f].numCaminhos;
+	}
+	*soma = total;
+	if (numCaminhos != NULL) *numCaminhos = caminhos;
+
+	LibertaTrabalhadores(t, p.numFios);
+	return csr;
+}
+
+
+/**
+ * @brief Calcula em paralelo o caminho de maior soma de pesos entre dois vrtices de um snapshot CSR.
+ *
+ * Verso paralela da procura com poda: os fios partilham a melhor soma atravs de um inteiro
+ * atmico e, no fim, fica o melhor caminho com o menor ndice de tarefa, o mesmo que a
+ * procura sequencial encontraria primeiro.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @param caminhoMaximo Array com pelo menos csr->numVertices posies onde fica o caminho.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima encontrada, ou 0 se no existir caminho com soma positiva.
+ */
+int CaminhoMaiorSomaParaleloCSR(GrafoCSR* csr, int origem, int destino, int numFios, int* caminhoMaximo, int* tamanhoMaximo) {
+	*tamanhoMaximo = 0;
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return 0;
+	}
+
+	ProcuraParalela p;
+	memset(&p, 0, sizeof(p));
+	p.csr = csr;
+	p.destino = destino;
+	p.soContagem = false;
+
+	TrabalhadorDFS* t;
+	if (!ExecutaProcuraParalela(&p, origem, numFios, &t)) return 0;
+
+	// Junta os resultados: maior soma e, em caso de empate, a tarefa mais  esquerda
+	TrabalhadorDFS* melhor = NULL;
+	for (int f = 0; f < p.numFios; f++) {
+		if (t[f].melhorTarefa < 0) continue;
+		if (melhor == NULL || t[f].melhorSoma > melhor->melhorSoma ||
+			(t[f].melhorSoma == melhor->melhorSoma && t[f].melhorTarefa < melhor->melhorTarefa)) {
+			melhor = &t[f];
+		}
+	}
+
+	int somaMaxima = 0;
+	if (melhor != NULL) {
+		somaMaxima = melhor->melhorSoma;
+		memcpy(caminhoMaximo, melhor->melhorCaminho, melhor->melhorTamanho * sizeof(int));
+		*tamanhoMaximo = melhor->melhorTamanho;
+	}
+
+	LibertaTrabalhadores(t, p.numFios);
+	return somaMaxima;
+}
+
+
+/*
+ * Tabela de todos os pares. Uma s procura exaustiva a partir de cada origem serve todos os
+ * destinos: sempre que o caminho atual chega a um vrtice com uma soma estritamente maior do
+ * que a melhor conhecida para ele, o caminho  copiado. Como os caminhos at cada destino so
+ * encontrados pela mesma ordem que na procura desse par, o resultado (soma e caminho)  igual
+ * ao de CaminhoMaiorSomaCSR com MOTOR_EXAUSTIVO. As origens so distribudas pelos fios 
+ * medida que estes ficam livres, atravs de um contador partilhado.
+ */
+
+typedef struct OrigensTabela {
+	GrafoCSR* csr;
+	volatile int proximaOrigem;
+	int* somas;				//numVertices x numVertices
+	int* tamanhos;			//nmero de vrtices do caminho de cada par
+	int** caminhosOrigem;	//caminhos de cada origem, seguidos, pela ordem dos destinos
+}OrigensTabela;
+
+
+typedef struct FioTabela {
+	OrigensTabela* origens;
+	bool erro;
+}FioTabela;
+
+
+/**
+ * @brief Calcula as linhas da tabela das origens que este fio for buscar ao contador partilhado.
+ */
+static void CalculaOrigensTabela(void* contexto) {
+	FioTabela* fio = (FioTabela*)contexto;
+	OrigensTabela* t = fio->origens;
+	GrafoCSR* csr = t->csr;
+	int n = csr->numVertices;
+
+	bool* visitado = (bool*)calloc((size_t)n + 1, sizeof(bool));
+	int* caminho = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	int* proxAresta = (int*)malloc(((size_t)n + 1) * sizeof(int));	//prxima aresta a explorar em cada nvel
+	int* somaNivel = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	int* melhores = (int*)malloc(((size_t)n * n + 1) * sizeof(int));	//melhor caminho at cada destino
+	if (visitado == NULL || caminho == NULL || proxAresta == NULL || somaNivel == NULL || melhores == NULL) {
+		fio->erro = true;
+	}
+
+	while (!fio->erro) {
+		int origem = IncrementaAtomico(&t->proximaOrigem);
+		if (origem >= n) break;
+		int* somas = t->somas + (size_t)origem * n;
+		int* tamanhos = t->tamanhos + (size_t)origem * n;
+
+		// Procura em profundidade iterativa a partir da origem, sem destino
+		int topo = 0;
+		caminho[0] = origem;
+		visitado[origem] = true;
+		proxAresta[0] = csr->inicioAdj[origem];
+		somaNivel[0] = 0;
+		while (topo >= 0) {
+			int u = caminho[topo];
+			int a = proxAresta[topo];
+			while (a < csr->inicioAdj[u + 1] && visitado[csr->destinos[a]]) {
+				a++;
+			}
+			if (a == csr->inicioAdj[u + 1]) {
+				visitado[u] = false; // backtracking
+				topo--;
+				continue;
+			}
+			proxAresta[topo] = a + 1;
+
+			int v = csr->destinos[a];
+			int soma = somaNivel[topo] + csr->pesos[a];
+			topo++;
+			caminho[topo] = v;
+			visitado[v] = true;
+			somaNivel[topo] = soma;
+			proxAresta[topo] = csr->inicioAdj[v];
+			if (soma > somas[v]) {
+				somas[v] = soma;
+				tamanhos[v] = topo + 1;
+				memcpy(melhores + (size_t)v * n, caminho, (topo + 1) * sizeof(int));
+			}
+		}
+
+		// Junta os caminhos desta origem, pela ordem dos destinos
+		size_t total = 0;
+		for (int d = 0; d < n; d++) {
+			total += tamanhos[d];
+		}
+		int* caminhos = (int*)malloc((total + 1) * sizeof(int));
+		if (caminhos == NULL) {
+			fio->erro = true;
+			break;
+		}
+		size_t pos = 0;
+		for (int d = 0; d < n; d++) {
+			memcpy(caminhos + pos, melhores + (size_t)d * n, tamanhos[d] * sizeof(int));
+			pos += tamanhos[d];
+		}
+		t->caminhosOrigem[origem] = caminhos;
+	}
+
+	free(visitado);
+	free(caminho);
+	free(proxAresta);
+	free(somaNivel);
+	free(melhores);
+}
+
+
+/**
+ * @brief Calcula o caminho de maior soma entre todos os pares de vrtices de um snapshot CSR.
+ *
+ * Faz uma procura exaustiva por origem, que serve todos os destinos dessa origem, e reparte as
+ * origens por vrios fios. Para cada par, a soma e o caminho so os de CaminhoMaiorSomaCSR com
+ * MOTOR_EXAUSTIVO. O custo  o de uma procura exaustiva por vrtice, pelo que s  vivel em
+ * grafos pequenos; a tabela ocupa no pior caso numVertices^3 inteiros.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @return A tabela, a libertar com DestroiTabelaCaminhos, ou NULL se a alocao falhar.
+ */
+TabelaCaminhos* TodosParesMaiorSomaCSR(GrafoCSR* csr, int numFios) {
+	if (csr == NULL) return NULL;
+	int n = csr->numVertices;
+	size_t pares = (size_t)n * n;
+	if (numFios <= 0) numFios = NumeroProcessadores();
+	if (numFios > n) numFios = (n > 0) ? n : 1;
+
+	TabelaCaminhos* tabela = (TabelaCaminhos*)malloc(sizeof(TabelaCaminhos));
+	OrigensTabela t;
+	t.csr = csr;
+	t.proximaOrigem = 0;
+	t.somas = (int*)calloc(pares + 1, sizeof(int));
+	t.tamanhos = (int*)calloc(pares + 1, sizeof(int));
+	t.caminhosOrigem = (int**)calloc((size_t)n + 1, sizeof(int*));
+	FioTabela* fios = (FioTabela*)calloc(numFios, sizeof(FioTabela));
+	bool erro = (tabela == NULL || t.somas == NULL || t.tamanhos == NULL || t.caminhosOrigem == NULL || fios == NULL);
+
+	if (!erro) {
+		for (int i = 0; i < numFios; i++) {
+			fios[i].origens = &t;
+		}
+		ExecutaEmParalelo(numFios, CalculaOrigensTabela, fios, sizeof(FioTabela));
+		for (int i = 0; i < numFios; i++) {
+			erro = erro || fios[i].erro;
+		}
+	}
+
+	// Junta as linhas de todas as origens num nico vetor de caminhos
+	if (!erro) {
+		tabela->numVertices = n;
+		tabela->somas = t.somas;
+		tabela->ficheiro = NULL;
+		tabela->inicioCaminhos = (long long*)malloc((pares + 1) * sizeof(long long));
+		erro = (tabela->inicioCaminhos == NULL);
+		if (!erro) {
+			tabela->inicioCaminhos[0] = 0;
+			for (size_t i = 0; i < pares; i++) {
+				tabela->inicioCaminhos[i + 1] = tabela->inicioCaminhos[i] + t.tamanhos[i];
+			}
+			tabela->caminhos = (int*)malloc(((size_t)tabela->inicioCaminhos[pares] + 1) * sizeof(int));
+			erro = (tabela->caminhos == NULL);
+		}
+		if (!erro) {
+			for (int o = 0; o < n; o++) {
+				long long inicio = tabela->inicioCaminhos[(size_t)o * n];
+				long long fim = tabela->inicioCaminhos[(size_t)(o + 1) * n];
+				memcpy(tabela->caminhos + inicio, t.caminhosOrigem[o], (size_t)(fim - inicio) * sizeof(int));
+			}
+			t.somas = NULL; // passou para a tabela
+		}
+		else {
+			free(tabela->inicioCaminhos);
+		}
+	}
+
+	if (t.caminhosOrigem != NULL) {
+		for (int o = 0; o < n; o++) {
+			free(t.caminhosOrigem[o]);
+		}
+	}
+	free(t.caminhosOrigem);
+	free(t.somas);
+	free(t.tamanhos);
+	free(fios);
+	if (erro) {
+		free(tabela);
+		return NULL;
+	}
+	return tabela;
+}
+
+
+/**
+ * @brief Calcula o caminho de maior soma entre todos os pares de vrtices do grafo.
+ *
+ * Congela o grafo num snapshot CSR e chama TodosParesMaiorSomaCSR; os ndices da tabela so
+ * os ids dos vrtices.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @return A tabela, a libertar com DestroiTabelaCaminhos, ou NULL em caso de erro.
+ */
+TabelaCaminhos* TodosParesMaiorSoma(Grafo* g, int numFios) {
+	GrafoCSR* csr = CongelaGrafo(g);
+	if (csr == NULL) return NULL;
+	TabelaCaminhos* tabela = TodosParesMaiorSomaCSR(csr, numFios);
+	DestroiGrafoCSR(csr);
+	return tabela;
+}
+
+
+/**
+ * @brief Consulta o resultado de um par na tabela de todos os pares.
+ *
+ * @param tabela Apontador para a tabela.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param caminho Apontador onde fica o incio do caminho, dentro da tabela (pode ser NULL).
+ * @param tamanho Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima, ou 0 se no existir caminho com soma positiva ou o par for invlido.
+ */
+int CaminhoTabela(TabelaCaminhos* tabela, int origem, int destino, const int** caminho, int* tamanho) {
+	*tamanho = 0;
+	if (caminho != NULL) *caminho = NULL;
+	if (tabela == NULL || origem < 0 || origem >= tabela->numVertices || destino < 0 || destino >= tabela->numVertices) {
+		return 0;
+	}
+
+	size_t par = (size_t)origem * tabela->numVertices + destino;
+	*tamanho = (int)(tabela->inicioCaminhos[par + 1] - tabela->inicioCaminhos[par]);
+	if (caminho != NULL) *caminho = tabela->caminhos + tabela->inicioCaminhos[par];
+	return tabela->somas[par];
+}
+
+
+/**
+ * @brief Guarda a tabela de todos os pares num ficheiro no formato de CabecalhoTabelaCaminhos.
+ *
+ * @param tabela Apontador para a tabela a guardar.
+ * @param fileName Nome do ficheiro a criar.
+ * @return true se o ficheiro foi escrito, false caso contrrio.
+ */
+bool GuardaTabelaCaminhos(TabelaCaminhos* tabela, char fileName[]) {
+	if (tabela == NULL || fileName == NULL) return false;
+
+	size_t pares = (size_t)tabela->numVertices * tabela->numVertices;
+	CabecalhoTabelaCaminhos cab;
+	memset(&cab, 0, sizeof(cab));
+	memcpy(cab.magia, "GTAB", 4);
+	cab.versao = VERSAOTABELACAMINHOS;
+	cab.numVertices = tabela->numVertices;
+	cab.tamanhoCaminhos = tabela->inicioCaminhos[pares];
+	cab.posInicioCaminhos = (long long)sizeof(cab);
+	cab.posSomas = cab.posInicioCaminhos + (long long)(pares + 1) * (long long)sizeof(long long);
+	cab.posCaminhos = cab.posSomas + (long long)pares * (long long)sizeof(int);
+
+	FILE* fp = fopen(fileName, "wb");
+	if (fp == NULL) return false;
+
+	size_t numCaminhos = (size_t)cab.tamanhoCaminhos;
+	bool ok = (fwrite(&cab, sizeof(cab), 1, fp) == 1)
+		&& (fwrite(tabela->inicioCaminhos, sizeof(long long), pares + 1, fp) == pares + 1)
+		&& (fwrite(tabela->somas, sizeof(int), pares, fp) == pares)
+		&& (fwrite(tabela->caminhos, sizeof(int), numCaminhos, fp) == numCaminhos);
+
+	if (fclose(fp) != 0) ok = false;
+	if (!ok) remove(fileName);
+	return ok;
+}
+
+
+/**
+ * @brief Abre um ficheiro da tabela de todos os pares mapeando-o em memria, sem o ler nem copiar.
+ *
+ * Como em MapeiaGrafoCSR, o ficheiro  todo validado antes de ser usado: o cabealho, os
+ * offsets (crescentes, de 0 a tamanhoCaminhos, e nenhum caminho com mais de numVertices
+ * vrtices) e os vrtices dos caminhos (ids vlidos). A tabela  s de leitura e deve ser
+ * libertada com DestroiTabelaCaminhos.
+ *
+ * @param fileName Nome do ficheiro escrito por GuardaTabelaCaminhos.
+ * @return Um apontador para a tabela, ou NULL se o ficheiro no existir ou for invlido.
+ */
+TabelaCaminhos* MapeiaTabelaCaminhos(char fileName[]) {
+	FicheiroMapeado* mapa = (FicheiroMapeado*)malloc(sizeof(FicheiroMapeado));
+	TabelaCaminhos* tabela = (TabelaCaminhos*)malloc(sizeof(TabelaCaminhos));
+	if (mapa == NULL || tabela == NULL || !MapeiaFicheiro(fileName, mapa)) {
+		free(mapa);
+		free(tabela);
+		return NULL;
+	}
+
+	CabecalhoTabelaCaminhos cab;
+	bool ok = (mapa->tamanho >= sizeof(cab));
+	if (ok) {
+		memcpy(&cab, mapa->dados, sizeof(cab));
+		ok = (memcmp(cab.magia, "GTAB", 4) == 0 && cab.versao == VERSAOTABELACAMINHOS
+			&& cab.numVertices >= 0 && cab.tamanhoCaminhos >= 0);
+	}
+	long long pares = ok ? (long long)cab.numVertices * cab.numVertices : 0;
+	// Os tamanhos das seces, em bytes, tm de caber num long long
+	ok = ok && pares < LLONG_MAX / (long long)sizeof(long long) && cab.tamanhoCaminhos <= LLONG_MAX / (long long)sizeof(int);
+	if (ok) {
+		// Cada seco tem de estar alinhada e dentro do ficheiro
+		long long tamanho = (long long)mapa->tamanho;
+		long long posicoes[3] = { cab.posInicioCaminhos, cab.posSomas, cab.posCaminhos };
+		long long tamanhos[3] = { (pares + 1) * (long long)sizeof(long long),
+			pares * (long long)sizeof(int),
+			cab.tamanhoCaminhos * (long long)sizeof(int) };
+		long long alinhamentos[3] = { sizeof(long long), sizeof(int), sizeof(int) };
+		for (int i = 0; i < 3 && ok; i++) {
+			ok = (posicoes[i] >= (long long)sizeof(cab) && posicoes[i] % alinhamentos[i] == 0
+				&& posicoes[i] <= tamanho && tamanhos[i] <= tamanho - posicoes[i]);
+		}
+	}
+	if (ok) {
+		tabela->numVertices = cab.numVertices;
+		tabela->inicioCaminhos = (long long*)(mapa->dados + cab.posInicioCaminhos);
+		tabela->somas = (int*)(mapa->dados + cab.posSomas);
+		tabela->caminhos = (int*)(mapa->dados + cab.posCaminhos);
+		tabela->ficheiro = mapa;
+		ok = (tabela->inicioCaminhos[0] == 0 && tabela->inicioCaminhos[pares] == cab.tamanhoCaminhos);
+	}
+	for (long long par = 0; ok && par < pares; par++) {
+		long long tamanhoCaminho = tabela->inicioCaminhos[par + 1] - tabela->inicioCaminhos[par];
+		ok = (tamanhoCaminho >= 0 && tamanhoCaminho <= cab.numVertices);
+	}
+	for (long long i = 0; ok && i < cab.tamanhoCaminhos; i++) {
+		ok = (tabela->caminhos[i] >= 0 && tabela->caminhos[i] < cab.numVertices);
+	}
+	if (!ok) {
+		DesmapeiaFicheiro(mapa);
+		free(mapa);
+		free(tabela);
+		return NULL;
+	}
+	return tabela;
+}
+
+
+/**
+ * @brief Liberta a memria de uma tabela de todos os pares.
+ *
+ * @param tabela Apontador para a tabela a destruir (pode ser NULL).
+ */
+void DestroiTabelaCaminhos(TabelaCaminhos* tabela) {
+	if (tabela == NULL) return;
+	if (tabela->ficheiro != NULL) {
+		// Os vetores apontam para o ficheiro mapeado
+		DesmapeiaFicheiro(tabela->ficheiro);
+		free(tabela->ficheiro);
+	}
+	else {
+		free(tabela->somas);
+		free(tabela->inicioCaminhos);
+		free(tabela->caminhos);
+	}
+	free(tabela);
+}
+
+#pragma endregion
+
+#pragma region Componentes
+
+/*
+ * Um caminho simples que sai de uma componente fortemente conexa no pode voltar a ela (haveria
+ * um ciclo na condensao), pelo que atravessa as componentes pela ordem topolgica, cada uma
+ * num s troo, de um vrtice de entrada at um vrtice da componente. O caminho de maior soma
+ * obtm-se em duas fases: primeiro, a maior soma interna de cada entrada at cada vrtice da
+ * sua componente, com procuras exaustivas limitadas  componente e independentes entre si,
+ * repartidas pelos fios; depois, uma programao dinmica pela condensao, em ordem
+ * topolgica, que junta os troos com as arestas entre componentes.
+ */
+
+/**
+ * @brief Calcula as componentes fortemente conexas de um snapshot CSR com o algoritmo de Tarjan, sem recurso.
+ *
+ * Uma componente fica completa quando termina o primeiro vrtice onde a procura entrou nela;
+ * por isso as componentes so numeradas pela ordem topolgica inversa da condensao.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param ativo Vrtices a considerar (NULL para todos); os restantes ficam com componente -1.
+ * @param componente Array com csr->numVertices posies onde fica a componente de cada vrtice.
+ * @return O nmero de componentes, ou -1 se a alocao falhar.
+ */
+static int TarjanCSR(GrafoCSR* csr, const bool* ativo, int* componente) {
+	int n = csr->numVertices;
+	int* indice = (int*)malloc(((size_t)n + 1) * sizeof(int));		//ordem de descoberta, -1 se por visitar
+	int* baixo = (int*)malloc(((size_t)n + 1) * sizeof(int));		//menor ndice alcanvel ainda na pilha
+	int* proxAresta = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	int* chamadas = (int*)malloc(((size_t)n + 1) * sizeof(int));	//vrtices em curso na procura em profundidade
+	int* pilha = (int*)malloc(((size_t)n + 1) * sizeof(int));		//vrtices ainda sem componente
+	bool* naPilha = (bool*)calloc((size_t)n + 1, sizeof(bool));
+	if (indice == NULL || baixo == NULL || proxAresta == NULL || chamadas == NULL || pilha == NULL || naPilha == NULL) {
+		free(indice);
+		free(baixo);
+		free(proxAresta);
+		free(chamadas);
+		free(pilha);
+		free(naPilha);
+		return -1;
+	}
+
+	for (int v = 0; v < n; v++) {
+		indice[v] = -1;
+		componente[v] = -1;
+	}
+
+	int contador = 0;
+	int numComponentes = 0;
+	int topoPilha = 0;
+	for (int s = 0; s < n; s++) {
+		if (indice[s] != -1 || (ativo != NULL && !ativo[s])) continue;
+
+		int topo = 0;
+		chamadas[0] = s;
+		indice[s] = baixo[s] = contador++;
+		proxAresta[s] = csr->inicioAdj[s];
+		pilha[topoPilha++] = s;
+		naPilha[s] = true;
+		while (topo >= 0) {
+			int v = chamadas[topo];
+			if (proxAresta[v] < csr->inicioAdj[v + 1]) {
+				int w = csr->destinos[proxAresta[v]++];
+				if (ativo != NULL && !ativo[w]) continue;
+				if (indice[w] == -1) {
+					indice[w] = baixo[w] = contador++;
+					proxAresta[w] = csr->inicioAdj[w];
+					pilha[topoPilha++] = w;
+					naPilha[w] = true;
+					chamadas[++topo] = w;
+				}
+				else if (naPilha[w] && indice[w] < baixo[v]) {
+					baixo[v] = indice[w];
+				}
+				continue;
+			}
+
+			// v terminou; se  a raiz da sua componente, esta sai da pilha
+			if (baixo[v] == indice[v]) {
+				int w;
+				do {
+					w = pilha[--topoPilha];
+					naPilha[w] = false;
+					componente[w] = numComponentes;
+				} while (w != v);
+				numComponentes++;
+			}
+			topo--;
+			if (topo >= 0 && baixo[v] < baixo[chamadas[topo]]) {
+				baixo[chamadas[topo]] = baixo[v];
+			}
+		}
+	}
+
+	free(indice);
+	free(baixo);
+	free(proxAresta);
+	free(chamadas);
+	free(pilha);
+	free(naPilha);
+	return numComponentes;
+}
+
+
+/**
+ * @brief Calcula as componentes fortemente conexas de um snapshot CSR e agrupa os vrtices de cada uma.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param ativo Vrtices a considerar (NULL para todos).
+ * @return As componentes, ou NULL se a alocao falhar.
+ */
+static ComponentesFortes* CalculaComponentes(GrafoCSR* csr, const bool* ativo) {
+	int n = csr->numVertices;
+	ComponentesFortes* c = (ComponentesFortes*)malloc(sizeof(ComponentesFortes));
+	if (c == NULL) return NULL;
+	c->numVertices = n;
+	c->componente = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	c->membros = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	c->inicioMembros = NULL;
+	c->numComponentes = (c->componente != NULL) ? TarjanCSR(csr, ativo, c->componente) : -1;
+	if (c->numComponentes >= 0) {
+		c->inicioMembros = (int*)calloc((size_t)c->numComponentes + 2, sizeof(int));
+	}
+	if (c->numComponentes < 0 || c->membros == NULL || c->inicioMembros == NULL) {
+		DestroiComponentesFortes(c);
+		return NULL;
+	}
+
+	// Ordenao por contagem dos vrtices pela sua componente
+	for (int v = 0; v < n; v++) {
+		if (c->componente[v] >= 0) c->inicioMembros[c->componente[v] + 2]++;
+	}
+	for (int k = 0; k < c->numComponentes; k++) {
+		c->inicioMembros[k + 2] += c->inicioMembros[k + 1];
+	}
+	for (int v = 0; v < n; v++) {
+		if (c->componente[v] >= 0) c->membros[c->inicioMembros[c->componente[v] + 1]++] = v;
+	}
+	return c;
+}
+
+
+/**
+ * @brief Calcula as componentes fortemente conexas de um snapshot CSR.
+ *
+ * Os ndices das componentes seguem a ordem topolgica inversa da condensao: uma aresta entre
+ * componentes diferentes vai sempre de uma componente para outra de ndice menor. Cada id sem
+ * vrtice forma uma componente sozinho.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @return As componentes, a libertar com DestroiComponentesFortes, ou NULL em caso de erro.
+ */
+ComponentesFortes* ComponentesFortesCSR(GrafoCSR* csr) {
+	if (csr == NULL) return NULL;
+	return CalculaComponentes(csr, NULL);
+}
+
+
+/**
+ * @brief Calcula as componentes fortemente conexas do grafo.
+ *
+ * Congela o grafo num snapshot CSR e chama ComponentesFortesCSR; os ndices do array
+ * componente so os ids dos vrtices.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @return As componentes, a libertar com DestroiComponentesFortes, ou NULL em caso de erro.
+ */
+ComponentesFortes* ComponentesFortesGrafo(Grafo* g) {
+	GrafoCSR* csr = CongelaGrafo(g);
+	if (csr == NULL) return NULL;
+	ComponentesFortes* componentes = ComponentesFortesCSR(csr);
+	DestroiGrafoCSR(csr);
+	return componentes;
+}
+
+
+/**
+ * @brief Calcula as componentes fortemente conexas dos vrtices que podem estar num caminho entre dois vrtices.
+ *
+ * S so considerados os vrtices alcanveis a partir da origem que alcanam o destino; os
+ * restantes ficam com componente -1. A componente do destino tem sempre o ndice 0 e a da
+ * origem o maior ndice.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @return As componentes, a libertar com DestroiComponentesFortes, ou NULL se no existir
+ * caminho de origem at destino ou em caso de erro.
+ */
+ComponentesFortes* ComponentesCaminhoCSR(GrafoCSR* csr, int origem, int destino) {
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return NULL;
+	}
+	bool* util = (bool*)malloc(((size_t)csr->numVertices + 1) * sizeof(bool));
+	if (util == NULL) return NULL;
+	ComponentesFortes* componentes = NULL;
+	if (AlcancaveisCSR(csr, origem, destino, util) == 1) {
+		componentes = CalculaComponentes(csr, util);
+	}
+	free(util);
+	return componentes;
+}
+
+
+/**
+ * @brief Liberta as componentes fortemente conexas.
+ *
+ * @param componentes Apontador para as componentes (pode ser NULL).
+ */
+void DestroiComponentesFortes(ComponentesFortes* componentes) {
+	if (componentes == NULL) return;
+	free(componentes->componente);
+	free(componentes->inicioMembros);
+	free(componentes->membros);
+	free(componentes);
+}
+
+
+typedef struct ProblemaComponentes {
+	GrafoCSR* csr;
+	ComponentesFortes* componentes;
+	int destino;
+	int* posMembro;				//posio de cada vrtice entre os membros da sua componente
+	int* inicioEntradas;		//incio das entradas de cada componente em entradas, numComponentes + 1
+	int* entradas;				//vrtices de entrada, agrupados por componente
+	size_t* inicioInternas;		//incio da matriz (entradas x membros) de cada componente em internas
+	long long* internas;		//maior soma interna de cada entrada at cada membro; LLONG_MIN se no h caminho
+	int* tarefas;				//componentes com mais de um vrtice, a repartir pelos fios
+	int numTarefas;
+	volatile int proximaTarefa;
+}ProblemaComponentes;
+
+
+typedef struct FioComponentes {
+	ProblemaComponentes* problema;
+	bool* visitado;
+	int* caminho;
+	int* proxAresta;			//prxima aresta a explorar em cada nvel
+	long long* somaNivel;
+}FioComponentes;
+
+
+/**
+ * @brief Procura exaustiva dentro de uma componente, a partir de um vrtice de entrada.
+ *
+ * Calcula a maior soma de um caminho simples, s com arestas da componente, da entrada at cada
+ * membro. O destino do problema termina os caminhos. Se alvo for um membro, guarda tambm o
+ * primeiro caminho encontrado com a maior soma at ele.
+ *
+ * @param fio Estado do fio, com buffers de csr->numVertices posies e visitado a false.
+ * @param entrada Vrtice de entrada.
+ * @param somas Array com uma posio por membro da componente.
+ * @param alvo Vrtice cujo caminho se pretende, ou -1.
+ * @param caminhoAlvo Array onde fica o caminho at alvo (pode ser NULL se alvo for -1).
+ * @param tamanhoAlvo Apontador para o nmero de vrtices desse caminho (pode ser NULL se alvo for -1).
+ */
+static void ProcuraNaComponente(FioComponentes* fio, int entrada, long long* somas, int alvo, int* caminhoAlvo, int* tamanhoAlvo) {
+	ProblemaComponentes* p = fio->problema;
+	GrafoCSR* csr = p->csr;
+	const int* componente = p->componentes->componente;
+	int c = componente[entrada];
+	int tamanho = p->componentes->inicioMembros[c + 1] - p->componentes->inicioMembros[c];
+	bool* visitado = fio->visitado;
+	int* caminho = fio->caminho;
+	int* proxAresta = fio->proxAresta;
+	long long* somaNivel = fio->somaNivel;
+
+	for (int j = 0; j < tamanho; j++) {
+		somas[j] = LLONG_MIN;
+	}
+	somas[p->posMembro[entrada]] = 0;
+	if (alvo == entrada) {
+		caminhoAlvo[0] = entrada;
+		*tamanhoAlvo = 1;
+	}
+
+	int topo = 0;
+	caminho[0] = entrada;
+	visitado[entrada] = true;
+	proxAresta[0] = csr->inicioAdj[entrada];
+	somaNivel[0] = 0;
+	while (topo >= 0) {
+		int u = caminho[topo];
+		int a = proxAresta[topo];
+		int fim = (u == p->destino) ? a : csr->inicioAdj[u + 1];
+		while (a < fim && (visitado[csr->destinos[a]] || componente[csr->destinos[a]] != c)) {
+			a++;
+		}
+		if (a == fim) {
+			visitado[u] = false; // backtracking
+			topo--;
+			continue;
+		}
+		proxAresta[topo] = a + 1;
+
+		int v = csr->destinos[a];
+		long long soma = somaNivel[topo] + csr->pesos[a];
+		topo++;
+		caminho[topo] = v;
+		visitado[v] = true;
+		somaNivel[topo] = soma;
+		proxAresta[topo] = csr->inicioAdj[v];
+		if (soma > somas[p->posMembro[v]]) {
+			somas[p->posMembro[v]] = soma;
+			if (v == alvo) {
+				memcpy(caminhoAlvo, caminho, (topo + 1) * sizeof(int));
+				*tamanhoAlvo = topo + 1;
+			}
+		}
+	}
+}
+
+
+/**
+ * @brief Calcula as somas internas das componentes que este fio for buscar ao contador partilhado.
+ */
+static void CalculaTrocosComponentes(void* contexto) {
+	FioComponentes* fio = (FioComponentes*)contexto;
+	ProblemaComponentes* p = fio->problema;
+	const int* inicioMembros = p->componentes->inicioMembros;
+
+	while (true) {
+		int k = IncrementaAtomico(&p->proximaTarefa);
+		if (k >= p->numTarefas) break;
+		int c = p->tarefas[k];
+		int tamanho = inicioMembros[c + 1] - inicioMembros[c];
+		for (int e = p->inicioEntradas[c]; e < p->inicioEntradas[c + 1]; e++) {
+			long long* somas = p->internas + p->inicioInternas[c] + (size_t)(e - p->inicioEntradas[c]) * tamanho;
+			ProcuraNaComponente(fio, p->entradas[e], somas, -1, NULL, NULL);
+		}
+	}
+}
+
+
+/**
+ * @brief Calcula o caminho de maior soma entre dois vrtices de um snapshot CSR, componente a componente.
+ *
+ * Decompe os vrtices que podem estar no caminho em componentes fortemente conexas (ver
+ * ComponentesCaminhoCSR). Dentro de cada componente, a procura exaustiva parte de cada vrtice
+ * de entrada (a origem, ou um vrtice com arestas de outra componente); as componentes so
+ * tratadas em paralelo. Os troos so depois juntos numa programao dinmica pela
+ * condensao, linear no nmero de arestas. O custo exponencial fica assim limitado ao tamanho
+ * de cada componente, em vez do grafo inteiro.
+ *
+ * A soma  a de CaminhoMaiorSomaCSR com MOTOR_EXAUSTIVO; entre caminhos empatados pode ser
+ * escolhido outro. Com uma s componente, tambm o caminho  o mesmo. Se a alocao falhar, 
+ * usado MOTOR_EXAUSTIVO.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param numFios Nmero de fios (0 ou negativo para usar todos os processadores).
+ * @param caminhoMaximo Array com pelo menos csr->numVertices posies onde fica o caminho.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima encontrada, ou 0 se no existir caminho com soma positiva.
+ */
+int CaminhoMaiorSomaComponentesCSR(GrafoCSR* csr, int origem, int destino, int numFios, int* caminhoMaximo, int* tamanhoMaximo) {
+	*tamanhoMaximo = 0;
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return 0;
+	}
+	ComponentesFortes* componentes = ComponentesCaminhoCSR(csr, origem, destino);
+	if (componentes == NULL) {
+		// Sem caminho a procura termina logo; sem memria, faz a procura global
+		return CaminhoMaiorSomaCSR(csr, origem, destino, MOTOR_EXAUSTIVO, caminhoMaximo, tamanhoMaximo);
+	}
+
+	int n = csr->numVertices;
+	int numComponentes = componentes->numComponentes;
+	const int* componente = componentes->componente;
+	const int* inicioMembros = componentes->inicioMembros;
+	const int* membros = componentes->membros;
+
+	ProblemaComponentes p;
+	p.csr = csr;
+	p.componentes = componentes;
+	p.destino = destino;
+	p.posMembro = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	p.inicioEntradas = (int*)calloc((size_t)numComponentes + 2, sizeof(int));
+	p.entradas = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	p.inicioInternas = (size_t*)malloc(((size_t)numComponentes + 1) * sizeof(size_t));
+	p.internas = NULL;
+	p.tarefas = (int*)malloc(((size_t)numComponentes + 1) * sizeof(int));
+	p.numTarefas = 0;
+	p.proximaTarefa = 0;
+	bool* entrada = (bool*)calloc((size_t)n + 1, sizeof(bool));
+	long long* chegada = (long long*)malloc(((size_t)n + 1) * sizeof(long long));	//maior soma ao entrar em cada vrtice
+	long long* saida = (long long*)malloc(((size_t)n + 1) * sizeof(long long));		//maior soma at cada vrtice
+	int* entradaEscolhida = (int*)malloc(((size_t)n + 1) * sizeof(int));	//entrada do melhor troo at cada vrtice
+	int* antecessor = (int*)malloc(((size_t)n + 1) * sizeof(int));		//vrtice de onde se chega a cada entrada
+	int* troco = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	long long* somasTroco = (long long*)malloc(((size_t)n + 1) * sizeof(long long));
+	if (numFios <= 0) numFios = NumeroProcessadores();
+	FioComponentes* fios = (FioComponentes*)calloc(numFios, sizeof(FioComponentes));
+	bool erro = (p.posMembro == NULL || p.inicioEntradas == NULL || p.entradas == NULL || p.inicioInternas == NULL ||
+		p.tarefas == NULL || entrada == NULL || chegada == NULL || saida == NULL || entradaEscolhida == NULL ||
+		antecessor == NULL || troco == NULL || somasTroco == NULL || fios == NULL);
+
+	// Entradas de cada componente e espao das somas internas
+	if (!erro) {
+		entrada[origem] = true;
+		for (int u = 0; u < n; u++) {
+			if (componente[u] < 0) continue;
+			for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+				int v = csr->destinos[a];
+				if (componente[v] >= 0 && componente[v] != componente[u]) entrada[v] = true;
+			}
+		}
+		for (int v = 0; v < n; v++) {
+			if (entrada[v]) p.inicioEntradas[componente[v] + 2]++;
+		}
+		size_t total = 0;
+		for (int k = 0; k < numComponentes; k++) {
+			int tamanho = inicioMembros[k + 1] - inicioMembros[k];
+			for (int i = inicioMembros[k]; i < inicioMembros[k + 1]; i++) {
+				p.posMembro[membros[i]] = i - inicioMembros[k];
+			}
+			p.inicioInternas[k] = total;
+			total += (size_t)p.inicioEntradas[k + 2] * tamanho;
+			p.inicioEntradas[k + 2] += p.inicioEntradas[k + 1];
+			if (tamanho > 1) p.tarefas[p.numTarefas++] = k;
+		}
+		for (int v = 0; v < n; v++) {
+			if (entrada[v]) p.entradas[p.inicioEntradas[componente[v] + 1]++] = v;
+		}
+		p.internas = (long long*)malloc((total + 1) * sizeof(long long));
+		erro = (p.internas == NULL);
+	}
+
+	if (numFios > p.numTarefas) numFios = (p.numTarefas > 0) ? p.numTarefas : 1;
+	for (int f = 0; !erro && f < numFios; f++) {
+		fios[f].problema = &p;
+		fios[f].visitado = (bool*)calloc((size_t)n + 1, sizeof(bool));
+		fios[f].caminho = (int*)malloc(((size_t)n + 1) * sizeof(int));
+		fios[f].proxAresta = (int*)malloc(((size_t)n + 1) * sizeof(int));
+		fios[f].somaNivel = (long long*)malloc(((size_t)n + 1) * sizeof(long long));
+		erro = (fios[f].visitado == NULL || fios[f].caminho == NULL || fios[f].proxAresta == NULL || fios[f].somaNivel == NULL);
+	}
+
+	int somaMaxima = 0;
+	bool recorre = erro;
+	if (!erro) {
+		// Somas internas: uma componente de um s vrtice s tem o caminho vazio
+		for (int k = 0; k < numComponentes; k++) {
+			if (inicioMembros[k + 1] - inicioMembros[k] == 1 && p.inicioEntradas[k + 1] > p.inicioEntradas[k]) {
+				p.internas[p.inicioInternas[k]] = 0;
+			}
+		}
+		if (p.numTarefas > 0) {
+			ExecutaEmParalelo(numFios, CalculaTrocosComponentes, fios, sizeof(FioComponentes));
+		}
+
+		// Programao dinmica pela condensao, em ordem topolgica (ndices decrescentes)
+		for (int v = 0; v < n; v++) {
+			chegada[v] = LLONG_MIN;
+			saida[v] = LLONG_MIN;
+		}
+		chegada[origem] = 0;
+		for (int c = numComponentes - 1; c >= 0; c--) {
+			int tamanho = inicioMembros[c + 1] - inicioMembros[c];
+			for (int e = p.inicioEntradas[c]; e < p.inicioEntradas[c + 1]; e++) {
+				int x = p.entradas[e];
+				if (chegada[x] == LLONG_MIN) continue;
+				const long long* somas = p.internas + p.inicioInternas[c] + (size_t)(e - p.inicioEntradas[c]) * tamanho;
+				for (int j = 0; j < tamanho; j++) {
+					if (somas[j] == LLONG_MIN) continue;
+					int y = membros[inicioMembros[c] + j];
+					long long soma = chegada[x] + somas[j];
+					if (saida[y] == LLONG_MIN || soma > saida[y]) {
+						saida[y] = soma;
+						entradaEscolhida[y] = x;
 					}
-					int res;
-					grafo = InsereVerticeGrafo(grafo, novoVertice, &res);
-					if (res != 1) {
-						fclose(fp);
-						return NULL;
+				}
+			}
+			// As arestas para outras componentes chegam s entradas destas
+			for (int i = inicioMembros[c]; i < inicioMembros[c + 1]; i++) {
+				int y = membros[i];
+				if (saida[y] == LLONG_MIN) continue;
+				for (int a = csr->inicioAdj[y]; a < csr->inicioAdj[y + 1]; a++) {
+					int v = csr->destinos[a];
+					if (componente[v] < 0 || componente[v] == c) continue;
+					long long soma = saida[y] + csr->pesos[a];
+					if (chegada[v] == LLONG_MIN || soma > chegada[v]) {
+						chegada[v] = soma;
+						antecessor[v] = y;
 					}
 				}
-				// Verifica se o vrtice de destino existe, se no, cria
-				if (!ExisteVerticeGrafo(grafo, colunaAtual)) {
-					Vertices* novoVertice = CriaVertice(colunaAtual);
-					if (novoVertice == NULL) {
-						fclose(fp);
+			}
+		}
 
-						return NULL;
-					}
-					int res;
-					grafo = InsereVerticeGrafo(grafo, novoVertice, &res);
-					if (res != 1) {
-						fclose(fp);
-						return NULL;
-					}
+		// Reconstri o caminho do destino para trs, refazendo a procura de cada troo
+		if (saida[destino] != LLONG_MIN && saida[destino] > 0) {
+			somaMaxima = (int)saida[destino];
+			int tamanho = 0;
+			int y = destino;
+			while (true) {
+				int x = entradaEscolhida[y];
+				int tamanhoTroco = 0;
+				ProcuraNaComponente(&fios[0], x, somasTroco, y, troco, &tamanhoTroco);
+				for (int i = tamanhoTroco - 1; i >= 0; i--) {
+					caminhoMaximo[tamanho++] = troco[i];
 				}
-				bool res;
-				grafo = InsereAdjacenciasGrafo(grafo, *numLinhas - 1, colunaAtual, valor, &res);
-				if (!res) {
-					fclose(fp);
-					return NULL;
+				if (x == origem) break;
+				y = antecessor[x];
+			}
+			for (int i = 0; i < tamanho / 2; i++) {
+				int aux = caminhoMaximo[i];
+				caminhoMaximo[i] = caminhoMaximo[tamanho - 1 - i];
+				caminhoMaximo[tamanho - 1 - i] = aux;
+			}
+			*tamanhoMaximo = tamanho;
+		}
+	}
+
+	if (fios != NULL) {
+		for (int f = 0; f < numFios; f++) {
+			free(fios[f].visitado);
+			free(fios[f].caminho);
+			free(fios[f].proxAresta);
+			free(fios[f].somaNivel);
+		}
+	}
+	free(fios);
+	free(p.posMembro);
+	free(p.inicioEntradas);
+	free(p.entradas);
+	free(p.inicioInternas);
+	free(p.internas);
+	free(p.tarefas);
+	free(entrada);
+	free(chegada);
+	free(saida);
+	free(entradaEscolhida);
+	free(antecessor);
+	free(troco);
+	free(somasTroco);
+	DestroiComponentesFortes(componentes);
+
+	if (recorre) {
+		return CaminhoMaiorSomaCSR(csr, origem, destino, MOTOR_EXAUSTIVO, caminhoMaximo, tamanhoMaximo);
+	}
+	return somaMaxima;
+}
+
+/**
+ * @brief Verifica se um snapshot CSR no tem ciclos, com o algoritmo de Kahn.
+ *
+ * Retira sucessivamente os vrtices sem arestas de entrada por retirar; o grafo  acclico se
+ * todos forem retirados. Um lacete (aresta de um vrtice para si prprio) conta como ciclo.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @return true se o grafo for acclico, false se tiver ciclos ou em caso de erro.
+ */
+bool GrafoAciclicoCSR(GrafoCSR* csr) {
+	if (csr == NULL) return false;
+	int n = csr->numVertices;
+	int* grau = (int*)calloc((size_t)n + 1, sizeof(int));	//arestas de entrada ainda por retirar
+	int* fila = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	if (grau == NULL || fila == NULL) {
+		free(grau);
+		free(fila);
+		return false;
+	}
+
+	for (int a = 0; a < csr->numArestas; a++) {
+		grau[csr->destinos[a]]++;
+	}
+	int inicio = 0, fim = 0;
+	for (int v = 0; v < n; v++) {
+		if (grau[v] == 0) fila[fim++] = v;
+	}
+	while (inicio < fim) {
+		int u = fila[inicio++];
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			if (--grau[csr->destinos[a]] == 0) fila[fim++] = csr->destinos[a];
+		}
+	}
+
+	free(grau);
+	free(fila);
+	return fim == n;
+}
+
+
+/**
+ * @brief Verifica se o grafo no tem ciclos.
+ *
+ * Congela o grafo num snapshot CSR e chama GrafoAciclicoCSR.
+ *
+ * @param g Apontador para a estrutura do grafo.
+ * @return true se o grafo for acclico, false se tiver ciclos ou em caso de erro.
+ */
+bool GrafoAciclico(Grafo* g) {
+	GrafoCSR* csr = CongelaGrafo(g);
+	if (csr == NULL) return false;
+	bool aciclico = GrafoAciclicoCSR(csr);
+	DestroiGrafoCSR(csr);
+	return aciclico;
+}
+
+
+/**
+ * @brief Calcula o caminho de maior soma entre dois vrtices de um snapshot CSR sem ciclos, em tempo linear.
+ *
+ * Sem ciclos, qualquer caminho  simples e a maior soma at cada vrtice s depende das dos
+ * seus antecessores: os vrtices que podem estar no caminho so percorridos por ordem
+ * topolgica (algoritmo de Kahn) e cada um guarda o antecessor da sua melhor soma, de onde se
+ * reconstri o caminho. Basta que esses vrtices no formem ciclos (os lacetes so ignorados);
+ * o resto do grafo pode t-los. Se formarem,  usado MOTOR_COMPONENTES; se a alocao falhar,
+ * MOTOR_EXAUSTIVO.
+ *
+ * A soma  a de CaminhoMaiorSomaCSR com MOTOR_EXAUSTIVO; entre caminhos empatados pode ser
+ * escolhido outro.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @param origem ID do vrtice de origem.
+ * @param destino ID do vrtice de destino.
+ * @param caminhoMaximo Array com pelo menos csr->numVertices posies onde fica o caminho.
+ * @param tamanhoMaximo Apontador para o nmero de vrtices do caminho (0 se no existir).
+ * @return A soma mxima encontrada, ou 0 se no existir caminho com soma positiva.
+ */
+int CaminhoMaiorSomaDAGCSR(GrafoCSR* csr, int origem, int destino, int* caminhoMaximo, int* tamanhoMaximo) {
+	*tamanhoMaximo = 0;
+	if (csr == NULL || origem < 0 || origem >= csr->numVertices || destino < 0 || destino >= csr->numVertices) {
+		return 0;
+	}
+	int n = csr->numVertices;
+	bool* util = (bool*)malloc(((size_t)n + 1) * sizeof(bool));
+	int* grau = (int*)calloc((size_t)n + 1, sizeof(int));
+	int* fila = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	long long* melhor = (long long*)malloc(((size_t)n + 1) * sizeof(long long));	//maior soma at cada vrtice
+	int* antecessor = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	int alcanca = -1;
+	if (util != NULL && grau != NULL && fila != NULL && melhor != NULL && antecessor != NULL) {
+		alcanca = AlcancaveisCSR(csr, origem, destino, util);
+	}
+	if (alcanca != 1) {
+		free(util);
+		free(grau);
+		free(fila);
+		free(melhor);
+		free(antecessor);
+		if (alcanca == 0) return 0;
+		return CaminhoMaiorSomaCSR(csr, origem, destino, MOTOR_EXAUSTIVO, caminhoMaximo, tamanhoMaximo);
+	}
+
+	// Graus de entrada entre os vrtices teis, sem lacetes
+	int numUteis = 0;
+	for (int u = 0; u < n; u++) {
+		melhor[u] = LLONG_MIN;
+		if (!util[u]) continue;
+		numUteis++;
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			int v = csr->destinos[a];
+			if (util[v] && v != u) grau[v]++;
+		}
+	}
+
+	// Sem ciclos, s a origem no tem antecessores teis; os restantes entram na fila quando
+	// ficam sem eles. Se a origem tiver antecessores, est num ciclo
+	int inicio = 0, fim = 0;
+	if (grau[origem] == 0) {
+		fila[fim++] = origem;
+		melhor[origem] = 0;
+	}
+	while (inicio < fim) {
+		int u = fila[inicio++];
+		for (int a = csr->inicioAdj[u]; a < csr->inicioAdj[u + 1]; a++) {
+			int v = csr->destinos[a];
+			if (!util[v] || v == u) continue;
+			long long soma = melhor[u] + csr->pesos[a];
+			if (melhor[v] == LLONG_MIN || soma > melhor[v]) {
+				melhor[v] = soma;
+				antecessor[v] = u;
+			}
+			if (--grau[v] == 0) fila[fim++] = v;
+		}
+	}
+
+	int somaMaxima = 0;
+	bool ciclico = (fim < numUteis);
+	if (!ciclico && melhor[destino] > 0) {
+		somaMaxima = (int)melhor[destino];
+		int tamanho = 0;
+		for (int v = destino; v != origem; v = antecessor[v]) {
+			caminhoMaximo[tamanho++] = v;
+		}
+		caminhoMaximo[tamanho++] = origem;
+		for (int i = 0; i < tamanho / 2; i++) {
+			int aux = caminhoMaximo[i];
+			caminhoMaximo[i] = caminhoMaximo[tamanho - 1 - i];
+			caminhoMaximo[tamanho - 1 - i] = aux;
+		}
+		*tamanhoMaximo = tamanho;
+	}
+
+	free(util);
+	free(grau);
+	free(fila);
+	free(melhor);
+	free(antecessor);
+	if (ciclico) {
+		return CaminhoMaiorSomaComponentesCSR(csr, origem, destino, 0, caminhoMaximo, tamanhoMaximo);
+	}
+	return somaMaxima;
+}
+
+#pragma endregion
+
+#pragma region Compacto
+
+/*
+ * Codificao zigzag: diferenas pequenas, positivas ou negativas, ficam com valores pequenos.
+ */
+static unsigned int Zigzag(int valor) {
+	return ((unsigned int)valor << 1) ^ (unsigned int)(valor >> 31);
+}
+
+
+/**
+ * @brief Escreve um inteiro sem sinal em varint (7 bits por byte, o bit alto indica continuao).
+ *
+ * @return Nmero de bytes escritos (se destino for NULL, s conta).
+ */
+static int EscreveVarint(unsigned char* destino, unsigned int valor) {
+	int n = 0;
+	while (valor >= 0x80) {
+		if (destino != NULL) destino[n] = (unsigned char)(valor | 0x80);
+		valor >>= 7;
+		n++;
+	}
+	if (destino != NULL) destino[n] = (unsigned char)valor;
+	return n + 1;
+}
+
+
+/**
+ * @brief L um varint de um fluxo limitado, rejeitando os que no cabem em 32 bits.
+ *
+ * @param p Apontador para a posio de leitura, que avana para o fim do varint.
+ * @param fim Fim do fluxo.
+ * @param valor Apontador para o valor lido.
+ * @return true se foi lido um varint completo de 1 a 5 bytes, false caso contrrio.
+ */
+static bool LeVarint(const unsigned char** p, const unsigned char* fim, unsigned int* valor) {
+	unsigned int v = 0;
+	for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+		if (*p >= fim) return false;
+		unsigned char byte = *(*p)++;
+		if (deslocamento == 28 && (byte & 0x70) != 0) return false; // mais de 32 bits
+		v |= (unsigned int)(byte & 0x7F) << deslocamento;
+		if ((byte & 0x80) == 0) {
+			*valor = v;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+ * Os bits so guardados do menos para o mais significativo, byte a byte, para que o fluxo
+ * no dependa da ordem de bytes da mquina. O buffer tem de estar a zeros.
+ */
+static void EscreveBits(unsigned char* buffer, long long bit, int numBits, unsigned int valor) {
+	unsigned long long v = (unsigned long long)valor << (bit & 7);
+	unsigned char* p = buffer + (bit >> 3);
+	for (int usados = 0; usados < (int)(bit & 7) + numBits; usados += 8) {
+		*p++ |= (unsigned char)v;
+		v >>= 8;
+	}
+}
+
+
+static unsigned int LeBits(const unsigned char* buffer, long long bit, int numBits) {
+	if (numBits == 0) return 0;
+	const unsigned char* p = buffer + (bit >> 3);
+	int deslocamento = (int)(bit & 7);
+	unsigned long long v = 0;
+	for (int i = 0, usados = 0; usados < deslocamento + numBits; i++, usados += 8) {
+		v |= (unsigned long long)p[i] << (8 * i);
+	}
+	return (unsigned int)((v >> deslocamento) & ((1ULL << numBits) - 1));
+}
+
+
+/**
+ * @brief Comprime um snapshot CSR: destinos em varint das diferenas e pesos bit-packed.
+ *
+ * Cada destino  guardado como a diferena (em zigzag) para o destino anterior do mesmo
+ * vrtice, ou para o prprio vrtice no caso do primeiro, pelo que listas ordenadas de ids
+ * prximos ocupam um byte por aresta. Os pesos usam o menor nmero de bits que cobre a
+ * amplitude entre o menor e o maior peso do grafo. A ordem das arestas  preservada.
+ *
+ * @param csr Apontador para o snapshot CSR.
+ * @return Um apontador para o grafo compacto, ou NULL se a alocao falhar.
+ */
+GrafoCompacto* ComprimeGrafoCSR(GrafoCSR* csr) {
+	if (csr == NULL) return NULL;
+
+	int n = csr->numVertices;
+	int m = csr->numArestas;
+	GrafoCompacto* gc = (GrafoCompacto*)calloc(1, sizeof(GrafoCompacto));
+	if (gc == NULL) return NULL;
+	gc->numVertices = n;
+	gc->numArestas = m;
+	gc->numIds = csr->numIds;
+	gc->inicioAdj = (int*)malloc(((size_t)n + 1) * sizeof(int));
+	gc->inicioBytes = (long long*)malloc(((size_t)n + 1) * sizeof(long long));
+	gc->ids = (int*)malloc(((size_t)csr->numIds + 1) * sizeof(int));
+	if (gc->inicioAdj == NULL || gc->inicioBytes == NULL || gc->ids == NULL) {
+		DestroiGrafoCompacto(gc);
+		return NULL;
+	}
+	memcpy(gc->inicioAdj, csr->inicioAdj, ((size_t)n + 1) * sizeof(int));
+	memcpy(gc->ids, csr->ids, (size_t)csr->numIds * sizeof(int));
+
+	// Primeira passagem: tamanho do fluxo de destinos e amplitude dos pesos
+	long long bytes = 0;
+	int pesoMinimo = 0;
+	int pesoMaximo = 0;
+	for (int v = 0; v < n; v++) {
+		gc->inicioBytes[v] = bytes;
+		int anterior = v;
+		for (int a = csr->inicioAdj[v]; a < csr->inicioAdj[v + 1]; a++) {
+			bytes += EscreveVarint(NULL, Zigzag(csr->destinos[a] - anterior));
+			anterior = csr->destinos[a];
+		}
+	}
+	gc->inicioBytes[n] = bytes;
+	for (int a = 0; a < m; a++) {
+		if (a == 0 || csr->pesos[a] < pesoMinimo) pesoMinimo = csr->pesos[a];
+		if (a == 0 || csr->pesos[a] > pesoMaximo) pesoMaximo = csr->pesos[a];
+	}
+	unsigned long long amplitude = (unsigned long long)((long long)pesoMaximo - pesoMinimo);
+	int bitsPeso = 0;
+	while (bitsPeso < 32 && (amplitude >> bitsPeso) != 0) {
+		bitsPeso++;
+	}
+	gc->pesoMinimo = pesoMinimo;
+	gc->bitsPeso = bitsPeso;
+
+	// Segunda passagem: escreve os dois fluxos (os pesos com 8 bytes de folga para a leitura)
+	size_t tamanhoPesos = (size_t)(((long long)m * bitsPeso + 7) / 8) + 8;
+	gc->alvos = (unsigned char*)malloc((size_t)bytes + 1);
+	gc->pesos = (unsigned char*)calloc(tamanhoPesos, 1);
+	if (gc->alvos == NULL || gc->pesos == NULL) {
+		DestroiGrafoCompacto(gc);
+		return NULL;
+	}
+	for (int v = 0; v < n; v++) {
+		unsigned char* p = gc->alvos + gc->inicioBytes[v];
+		int anterior = v;
+		for (int a = csr->inicioAdj[v]; a < csr->inicioAdj[v + 1]; a++) {
+			p += EscreveVarint(p, Zigzag(csr->destinos[a] - anterior));
+			anterior = csr->destinos[a];
+			EscreveBits(gc->pesos, (long long)a * bitsPeso, bitsPeso, (unsigned int)((long long)csr->pesos[a] - pesoMinimo));
+		}
+	}
+
+	return gc;
+}
+
+
+/**
+ * @brief Posiciona um cursor no incio das adjacncias de um vrtice do grafo compacto.
+ *
+ * @param gc Apontador para o grafo compacto.
+ * @param vertice O vrtice cujas adjacncias vo ser lidas.
+ * @param cursor Apontador para o cursor a iniciar.
+ */
+void IniciaVizinhos(GrafoCompacto* gc, int vertice, CursorVizinhos* cursor) {
+	cursor->p = gc->alvos + gc->inicioBytes[vertice];
+	cursor->restantes = gc->inicioAdj[vertice + 1] - gc->inicioAdj[vertice];
+	cursor->anterior = vertice;
+	cursor->pesos = gc->pesos;
+	cursor->bit = (long long)gc->inicioAdj[vertice] * gc->bitsPeso;
+	cursor->bitsPeso = gc->bitsPeso;
+	cursor->pesoMinimo = gc->pesoMinimo;
+}
+
+
+/**
+ * @brief Descodifica a prxima adjacncia de um cursor.
+ *
+ * @param cursor Apontador para o cursor.
+ * @param destino Apontador para o id de destino da aresta.
+ * @param peso Apontador para o peso da aresta.
+ * @return true se havia mais uma adjacncia, false se o vrtice no tem mais.
+ */
+bool ProximoVizinho(CursorVizinhos* cursor, int* destino, int* peso) {
+	if (cursor->restantes == 0) return false;
+	cursor->restantes--;
+
+	// No mximo 5 bytes (32 bits); os ficheiros mapeados j foram validados por LeVarint
+	const unsigned char* p = cursor->p;
+	unsigned int valor = 0;
+	int deslocamento = 0;
+	unsigned char byte;
+	do {
+		byte = *p++;
+		valor |= (unsigned int)(byte & 0x7F) << deslocamento;
+		deslocamento += 7;
+	} while ((byte & 0x80) && deslocamento < 35);
+	cursor->p = p;
+	cursor->anterior += (int)((valor >> 1) ^ (0u - (valor & 1)));
+	*destino = cursor->anterior;
+
+	*peso = (int)((long long)cursor->pesoMinimo + LeBits(cursor->pesos, cursor->bit, cursor->bitsPeso));
+	cursor->bit += cursor->bitsPeso;
+	return true;
+}
+
+
+/**
+ * @brief Descomprime um grafo compacto para um snapshot CSR, para usar os motores de procura.
+ *
+ * @param gc Apontador para o grafo compacto.
+ * @return Um apontador para o snapshot CSR, ou NULL se a alocao falhar.
+ */
+GrafoCSR* DescomprimeGrafo(GrafoCompacto* gc) {
+	if (gc == NULL) return NULL;
+
+	GrafoCSR* csr = (GrafoCSR*)malloc(sizeof(GrafoCSR));
+	if (csr == NULL) return NULL;
+	csr->ficheiro = NULL;
+	csr->offsetsAlocados = false;
+	csr->numVertices = gc->numVertices;
+	csr->numArestas = gc->numArestas;
+	csr->numIds = gc->numIds;
+	csr->inicioAdj = (int*)malloc(((size_t)gc->numVertices + 1) * sizeof(int));
+	csr->destinos = (int*)malloc(((size_t)gc->numArestas + 1) * sizeof(int));
+	csr->pesos = (int*)malloc(((size_t)gc->numArestas + 1) * sizeof(int));
+	csr->ids = (int*)malloc(((size_t)gc->numIds + 1) * sizeof(int));
+	if (csr->inicioAdj == NULL || csr->destinos == NULL || csr->pesos == NULL || csr->ids == NULL) {
+		DestroiGrafoCSR(csr);
+		return NULL;
+	}
+	memcpy(csr->inicioAdj, gc->inicioAdj, ((size_t)gc->numVertices + 1) * sizeof(int));
+	memcpy(csr->ids, gc->ids, (size_t)gc->numIds * sizeof(int));
+
+	CursorVizinhos cursor;
+	for (int v = 0; v < gc->numVertices; v++) {
+		int a = gc->inicioAdj[v];
+		IniciaVizinhos(gc, v, &cursor);
+		while (ProximoVizinho(&cursor, &csr->destinos[a], &csr->pesos[a])) {
+			a++;
+		}
+	}
+	return csr;
+}
+
+
+/**
+ * @brief Liberta a memria de um grafo compacto.
+ *
+ * @param gc Apontador para o grafo compacto a destruir (pode ser NULL).
+ */
+void DestroiGrafoCompacto(GrafoCompacto* gc) {
+	if (gc == NULL) return;
+	if (gc->ficheiro != NULL) {
+		DesmapeiaFicheiro(gc->ficheiro);
+		free(gc->ficheiro);
+		if (gc->offsetsAlocados) {
+			free(gc->inicioAdj);
+			free(gc->inicioBytes);
+		}
+	}
+	else {
+		free(gc->inicioAdj);
+		free(gc->inicioBytes);
+		free(gc->alvos);
+		free(gc->pesos);
+		free(gc->ids);
+	}
+	free(gc);
+}
+
+
+/**
+ * @brief Guarda um grafo compacto num ficheiro no formato descrito por CabecalhoGrafoCompacto.
+ *
+ * Tal como em GuardaGrafoCSR, s  guardado um offset por vrtice existente.
+ *
+ * @param gc Apontador para o grafo compacto.
+ * @param fileName Nome do ficheiro a criar.
+ * @return true se o ficheiro foi escrito, false caso contrrio.
+ */
+bool GuardaGrafoCompacto(GrafoCompacto* gc, char fileName[]) {
+	if (gc == NULL || fileName == NULL) return false;
+
+	// Os ids sem vrtice no tm arestas, logo tambm no tm bytes no fluxo de destinos
+	size_t numOffsets = (size_t)gc->numIds + 1;
+	int* offsets = ReduzOffsets(gc->inicioAdj, gc->ids, gc->numIds, gc->numArestas);
+	long long* offsetsBytes = (long long*)malloc(numOffsets * sizeof(long long));
+	if (offsets == NULL || offsetsBytes == NULL) {
+		free(offsets);
+		free(offsetsBytes);
+		return false;
+	}
+	for (int k = 0; k < gc->numIds; k++) {
+		offsetsBytes[k] = gc->inicioBytes[gc->ids[k]];
+	}
+	offsetsBytes[gc->numIds] = gc->inicioBytes[gc->numVertices];
+
+	CabecalhoGrafoCompacto cab;
+	memset(&cab, 0, sizeof(cab));
+	memcpy(cab.magia, "GCMP", 4);
+	cab.versao = VERSAOGRAFOCOMPACTO;
+	cab.numVertices = gc->numVertices;
+	cab.numArestas = gc->numArestas;
+	cab.pesoMinimo = gc->pesoMinimo;
+	cab.bitsPeso = gc->bitsPeso;
+	cab.numIds = gc->numIds;
+	cab.posInicioBytes = (long long)sizeof(cab);
+	cab.posInicioAdj = cab.posInicioBytes + (long long)(numOffsets * sizeof(long long));
+	cab.posIds = cab.posInicioAdj + (long long)(numOffsets * sizeof(int));
+	cab.posAlvos = cab.posIds + (long long)((size_t)gc->numIds * sizeof(int));
+	cab.tamanhoAlvos = gc->inicioBytes[gc->numVertices];
+	cab.posPesos = cab.posAlvos + cab.tamanhoAlvos;
+	cab.tamanhoPesos = ((long long)gc->numArestas * gc->bitsPeso + 7) / 8 + 8;
+
+	FILE* fp = fopen(fileName, "wb");
+	bool ok = (fp != NULL)
+		&& (fwrite(&cab, sizeof(cab), 1, fp) == 1)
+		&& (fwrite(offsetsBytes, sizeof(long long), numOffsets, fp) == numOffsets)
+		&& (fwrite(offsets, sizeof(int), numOffsets, fp) == numOffsets)
+		&& (fwrite(gc->ids, sizeof(int), numOffsets - 1, fp) == numOffsets - 1)
+		&& (fwrite(gc->alvos, 1, (size_t)cab.tamanhoAlvos, fp) == (size_t)cab.tamanhoAlvos)
+		&& (fwrite(gc->pesos, 1, (size_t)cab.tamanhoPesos, fp) == (size_t)cab.tamanhoPesos);
+	free(offsets);
+	free(offsetsBytes);
+	if (fp == NULL) return false;
+
+	if (fclose(fp) != 0) ok = false;
+	if (!ok) remove(fileName);
+	return ok;
+}
+
+
+/**
+ * @brief Verifica o fluxo de destinos de um grafo compacto.
+ *
+ * Cada vrtice tem de ocupar exatamente o seu intervalo de bytes com as suas arestas, em
+ * varints de 32 bits, e todos os destinos tm de estar dentro do espao de ids.
+ */
+static bool ValidaAlvosCompacto(GrafoCompacto* gc) {
+	for (int k = 0; k < gc->numIds; k++) {
+		int v = gc->ids[k];
+		const unsigned char* p = gc->alvos + gc->inicioBytes[v];
+		const unsigned char* fim = gc->alvos + gc->inicioBytes[v + 1];
+		long long anterior = v;
+		for (int a = gc->inicioAdj[v]; a < gc->inicioAdj[v + 1]; a++) {
+			unsigned int valor;
+			if (!LeVarint(&p, fim, &valor)) return false;
+			anterior += (int)((valor >> 1) ^ (0u - (valor & 1)));
+			if (anterior < 0 || anterior >= gc->numVertices) return false;
+		}
+		if (p != fim) return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Abre um ficheiro compacto mapeando-o em memria, sem o ler nem descomprimir.
+ *
+ * Tal como MapeiaGrafoCSR, s os offsets so copiados, e s quando os ids so esparsos, e o
+ * ficheiro  todo validado em O(V + E): o cabealho, os ids, os offsets (crescentes e dentro
+ * dos fluxos) e o fluxo de destinos (ver ValidaAlvosCompacto), que  descodificado uma vez.
+ * Depois disso, as adjacncias so descodificadas  medida que so lidas, com IniciaVizinhos
+ * e ProximoVizinho, sem mais verificaes.
+ *
+ * @param fileName Nome do ficheiro compacto.
+ * @return Um apontador para o grafo compacto, ou NULL se o ficheiro no existir ou for invlido.
+ */
+GrafoCompacto* MapeiaGrafoCompacto(char fileName[]) {
+	FicheiroMapeado* mapa = (FicheiroMapeado*)malloc(sizeof(FicheiroMapeado));
+	GrafoCompacto* gc = (GrafoCompacto*)calloc(1, sizeof(GrafoCompacto));
+	if (mapa == NULL || gc == NULL || !MapeiaFicheiro(fileName, mapa)) {
+		free(mapa);
+		free(gc);
+		return NULL;
+	}
+
+	CabecalhoGrafoCompacto cab;
+	bool ok = (mapa->tamanho >= sizeof(cab));
+	if (ok) {
+		memcpy(&cab, mapa->dados, sizeof(cab));
+		ok = (memcmp(cab.magia, "GCMP", 4) == 0 && cab.versao == VERSAOGRAFOCOMPACTO
+			&& cab.numVertices >= 0 && cab.numArestas >= 0 && cab.bitsPeso >= 0 && cab.bitsPeso <= 32
+			&& cab.posInicioBytes % sizeof(long long) == 0 && cab.posInicioAdj % sizeof(int) == 0
+			&& cab.tamanhoPesos >= ((long long)cab.numArestas * cab.bitsPeso + 7) / 8 + 8);
+	}
+	if (ok) {
+		// Cada seco tem de estar dentro do ficheiro
+		long long tamanho = (long long)mapa->tamanho;
+		long long numOffsets = (long long)cab.numIds + 1;
+		long long posicoes[5] = { cab.posInicioBytes, cab.posInicioAdj, cab.posIds, cab.posAlvos, cab.posPesos };
+		long long tamanhos[5] = { numOffsets * (long long)sizeof(long long), numOffsets * (long long)sizeof(int),
+			(long long)cab.numIds * (long long)sizeof(int), cab.tamanhoAlvos, cab.tamanhoPesos };
+		ok = (cab.numIds >= 0 && cab.numIds <= cab.numVertices && cab.posIds % sizeof(int) == 0);
+		for (int i = 0; i < 5 && ok; i++) {
+			ok = (posicoes[i] >= (long long)sizeof(cab) && tamanhos[i] >= 0
+				&& posicoes[i] <= tamanho && tamanhos[i] <= tamanho - posicoes[i]);
+		}
+	}
+	const long long* offsetsBytes = NULL;
+	const int* offsets = NULL;
+	if (ok) {
+		gc->numVertices = cab.numVertices;
+		gc->numArestas = cab.numArestas;
+		gc->pesoMinimo = cab.pesoMinimo;
+		gc->bitsPeso = cab.bitsPeso;
+		gc->numIds = cab.numIds;
+		gc->ids = (int*)(mapa->dados + cab.posIds);
+		gc->alvos = (unsigned char*)(mapa->dados + cab.posAlvos);
+		gc->pesos = (unsigned char*)(mapa->dados + cab.posPesos);
+		gc->ficheiro = mapa;
+		gc->offsetsAlocados = false;
+		offsetsBytes = (const long long*)(mapa->dados + cab.posInicioBytes);
+		offsets = (const int*)(mapa->dados + cab.posInicioAdj);
+		ok = (IdsValidos(gc->ids, cab.numIds, cab.numVertices)
+			&& offsets[0] == 0 && offsets[cab.numIds] == cab.numArestas
+			&& offsetsBytes[0] == 0 && offsetsBytes[cab.numIds] == cab.tamanhoAlvos);
+	}
+	for (int k = 0; ok && k < cab.numIds; k++) {
+		ok = (offsets[k] <= offsets[k + 1] && offsetsBytes[k] <= offsetsBytes[k + 1]);
+	}
+	if (ok) {
+		// Com todos os ids de 0 a n-1 os offsets j esto indexados por id
+		if (cab.numIds == cab.numVertices) {
+			gc->inicioAdj = (int*)offsets;
+			gc->inicioBytes = (long long*)offsetsBytes;
+		}
+		else {
+			gc->inicioAdj = ExpandeOffsets(offsets, gc->ids, cab.numIds, cab.numVertices);
+			gc->inicioBytes = (long long*)malloc(((size_t)cab.numVertices + 1) * sizeof(long long));
+			gc->offsetsAlocados = true;
+			ok = (gc->inicioAdj != NULL && gc->inicioBytes != NULL);
+			for (int v = 0, k = 0; ok && v <= cab.numVertices; v++) {
+				gc->inicioBytes[v] = offsetsBytes[k];
+				if (k < cab.numIds && gc->ids[k] == v) k++;
+			}
+		}
+	}
+	if (ok) ok = ValidaAlvosCompacto(gc);
+	if (!ok) {
+		if (gc->offsetsAlocados) {
+			free(gc->inicioAdj);
+			free(gc->inicioBytes);
+		}
+		DesmapeiaFicheiro(mapa);
+		free(mapa);
+		free(gc);
+		return NULL;
+	}
+	return gc;
+}
+
+
+/**
+ * @brief Guarda um grafo em formato compacto (ver ComprimeGrafoCSR).
+ *
+ * Alternativa a GuardaGrafoBinario para grafos grandes: o ficheiro ocupa tipicamente entre
+ * um quarto e metade do formato CSR e pode ser aberto com MapeiaGrafoCompacto.
+ *
+ * @param grafo Apontador para a estrutura do grafo que ser guardado.
+ * @param fileName Nome do ficheiro binrio onde o grafo ser guardado.
+ * @return true se o grafo foi salvo com sucesso, false caso contrrio.
+ */
+bool GuardaGrafoBinarioCompacto(Grafo* grafo, char fileName[]) {
+	if (grafo == NULL || fileName == NULL) return false;
+
+	GrafoCSR* csr = CongelaGrafo(grafo);
+	GrafoCompacto* gc = ComprimeGrafoCSR(csr);
+	DestroiGrafoCSR(csr);
+	if (gc == NULL) return false;
+
+	bool ok = GuardaGrafoCompacto(gc, fileName);
+	DestroiGrafoCompacto(gc);
+	return ok;
+}
+
+
+/**
+ * @brief Entrega a um visitante todos os caminhos entre dois vrtices de um grafo compacto.
+ *
+ * Equivalente a PercorreCaminhosCSR, mas cada nvel da pilha guarda um cursor que descodifica
+ * as adjacncias do vrtice  medida que a procura avana, sem descomprimir o grafo.
+ *
+ * @param gc Apontador para o grafo compacto.
+ * @param origem O vrtice de origem para a procura.
+ * @param destino O vrtice de destino para a procura.
+ * @param visitante Funo chamada para cada caminho encontrado.
+ * @param contexto Apontador passado ao visitante.
+ * @return Apontador para o grafo compacto, ou NULL se os parmetros forem invlidos.
+ */
+GrafoCompacto* PercorreCaminhosCompacto(GrafoCompacto* gc, int origem, int destino, VisitanteCaminho visitante, void* contexto) {
+	if (gc == NULL || visitante == NULL || origem < 0 || origem >= gc->numVertices || destino < 0 || destino >= gc->numVertices) {
+		return NULL;
+	}
+
+	int n = gc->numVertices;
+	bool* visitado = (bool*)calloc(n, sizeof(bool));
+	int* caminho = (int*)malloc(n * sizeof(int));
+	CursorVizinhos* cursor = (CursorVizinhos*)malloc(n * sizeof(CursorVizinhos));
+	int* somas = (int*)malloc(n * sizeof(int));
+	if (visitado == NULL || caminho == NULL || cursor == NULL || somas == NULL) {
+		free(visitado);
+		free(caminho);
+		free(cursor);
+		free(somas);
+		return NULL;
+	}
+
+	int topo = 0;
+	int v = origem;
+	int soma = 0;
+	while (true) {
+		visitado[v] = true;
+		caminho[topo] = v;
+
+		if (v == destino) {
+			if (!visitante(caminho, topo + 1, soma, contexto)) break;
+			visitado[v] = false;
+			topo--;
+		}
+		else {
+			IniciaVizinhos(gc, v, &cursor[topo]);
+			somas[topo] = soma;
+		}
+
+		v = -1;
+		while (topo >= 0) {
+			int w, peso;
+			bool encontrou = false;
+			while (ProximoVizinho(&cursor[topo], &w, &peso)) {
+				if (!visitado[w]) {
+					encontrou = true;
+					break;
 				}
 			}
-			// Avana para a proxima coluna
-			token = strtok(NULL, ";");
-			colunaAtual++;
+			if (encontrou) {
+				v = w;
+				soma = somas[topo] + peso;
+				break;
+			}
+			visitado[caminho[topo]] = false;
+			topo--;
+		}
+		if (v < 0) break;
+		topo++;
+	}
+
+	free(visitado);
+	free(caminho);
+	free(cursor);
+	free(somas);
+	return gc;
+}
+
+#pragma endregion
+
+#pragma region Diario
+
+/**
+ * @brief Aplica ao grafo os registos de um dirio, a partir da posio atual do ficheiro.
+ *
+ * Um registo incompleto no fim do ficheiro (escrita interrompida)  ignorado.
+ *
+ * @return O nmero de bytes de registos completos lidos, ou -1 se houver um registo invlido.
+ */
+static long long RepoeDiario(Grafo* g, FILE* fp) {
+	long long lidos = 0;
+	RegistoDiario r;
+	while (fread(&r, sizeof(r), 1, fp) == 1) {
+		bool ok;
+		int res;
+		switch (r.tipo) {
+		case DIARIO_INSERE_VERTICE: {
+			Vertices* novo = CriaVertice(r.origem);
+			InsereVerticeGrafo(g, novo, &res);
+			if (res != 1) free(novo);
+			break;
 		}
-		if (colunaAtual > *numColunas) {
-			*numColunas = colunaAtual;
+		case DIARIO_INSERE_ADJ:
+			InsereAdjacenciasGrafo(g, r.origem, r.destino, r.peso, &ok);
+			break;
+		case DIARIO_ELIMINA_ADJ:
+			EliminaAdjGrafo(g, r.origem, r.destino, &ok);
+			break;
+		case DIARIO_ELIMINA_VERTICE:
+			EliminaVerticeGrafo(g, r.origem, &ok);
+			break;
+		default:
+			return -1;
 		}
+		lidos += (long long)sizeof(r);
+	}
+	return lidos;
+}
+
+
+/**
+ * @brief Calcula a soma de verificao (FNV-1a de 64 bits) do contedo de um snapshot.
+ *
+ * @param fileName Nome do ficheiro.
+ * @param soma Apontador para a soma; 0 se o ficheiro no existir.
+ * @return true se a soma foi calculada ou o ficheiro no existe, false se no for possvel l-lo.
+ */
+static bool SomaSnapshot(const char* fileName, unsigned long long* soma) {
+	*soma = 0;
+	FILE* teste = fopen(fileName, "rb");
+	if (teste == NULL) return true;
+	fclose(teste);
+
+	FicheiroMapeado mapa;
+	if (!MapeiaFicheiro((char*)fileName, &mapa)) return false;
+	unsigned long long h = 14695981039346656037ULL;
+	for (size_t i = 0; i < mapa.tamanho; i++) {
+		h = (h ^ (unsigned char)mapa.dados[i]) * 1099511628211ULL;
 	}
+	DesmapeiaFicheiro(&mapa);
+	*soma = h;
+	return true;
+}
 
-	fclose(fp);
-	return grafo;
+
+/**
+ * @brief Substitui um ficheiro por outro numa s operao do sistema de ficheiros.
+ */
+static bool SubstituiFicheiro(const char* origem, const char* destino) {
+#ifdef _WIN32
+	return MoveFileExA(origem, destino, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return rename(origem, destino) == 0;
+#endif
 }
 
 
 /**
- * @brief Guarda a estrutura de um grafo em um ficheiro binrio.
+ * @brief Devolve o nome do ficheiro temporrio associado a um ficheiro (nome seguido de ".tmp").
+ *
+ * @return O nome, a libertar com free, ou NULL se a alocao falhar.
+ */
+static char* NomeTemporario(const char* fileName) {
+	char* nome = (char*)malloc(strlen(fileName) + 5);
+	if (nome != NULL) sprintf(nome, "%s.tmp", fileName);
+	return nome;
+}
+
+
+/**
+ * @brief Escreve o cabealho de um dirio vazio, com a soma do snapshot a que pertence.
+ */
+static bool IniciaFicheiroDiario(FILE* fp, unsigned long long somaSnapshot) {
+	char cabecalho[16] = { 'G', 'D', 'I', 'A' };
+	int versao = VERSAODIARIO;
+	memcpy(cabecalho + 4, &versao, sizeof(int));
+	memcpy(cabecalho + 8, &somaSnapshot, sizeof(unsigned long long));
+	return fwrite(cabecalho, sizeof(cabecalho), 1, fp) == 1 && fflush(fp) == 0;
+}
+
+
+/**
+ * @brief L o cabealho de um dirio, deixando o ficheiro posicionado no primeiro registo.
+ *
+ * @param fp O ficheiro do dirio, no incio.
+ * @param somaSnapshot Soma do snapshot atual (ver SomaSnapshot).
+ * @param confere Apontador onde fica true se o dirio pertence a este snapshot.
+ * @return O tamanho do cabealho, 0 se o ficheiro no tiver um cabealho completo (falha antes
+ * de este ser escrito; o dirio est vazio), ou -1 se no for um dirio.
+ */
+static int LeCabecalhoDiario(FILE* fp, unsigned long long somaSnapshot, bool* confere) {
+	char cabecalho[16];
+	size_t lidos = fread(cabecalho, 1, sizeof(cabecalho), fp);
+	int versao = 0;
+	*confere = false;
+	if (lidos < sizeof(cabecalho)) {
+		return (memcmp(cabecalho, "GDIA", lidos < 4 ? lidos : 4) == 0) ? 0 : -1;
+	}
+	memcpy(&versao, cabecalho + 4, sizeof(int));
+	if (memcmp(cabecalho, "GDIA", 4) != 0 || versao != VERSAODIARIO) return -1;
+	unsigned long long soma;
+	memcpy(&soma, cabecalho + 8, sizeof(unsigned long long));
+	*confere = (soma == somaSnapshot);
+	return (int)sizeof(cabecalho);
+}
+
+
+/**
+ * @brief Abre um grafo guardado num snapshot e num dirio de alteraes.
  *
- * Esta funo percorre todos os vrtices e as suas adjacncias de um grafo e escreve as informaes
- * em um ficheiro binrio para que possam ser recuperadas posteriormente.
+ * O snapshot (ficheiro escrito por GuardaGrafoBinario)  mapeado e convertido num grafo
+ * altervel, e os registos do dirio so aplicados por ordem. A partir da, cada insero ou
+ * remoo feita com InsereVerticeGrafo, InsereAdjacenciasGrafo, EliminaAdjGrafo ou
+ * EliminaVerticeGrafo acrescenta um registo de tamanho fixo ao dirio, em vez de obrigar a
+ * reescrever o grafo inteiro; se o registo no puder ser escrito, a alterao no  feita e a
+ * funo indica insucesso. Se algum dos ficheiros no existir,  tratado como vazio, tal
+ * como um dirio sem cabealho completo.
  *
- * @param grafo Apontador para a estrutura do grafo que ser guardado.
- * @param fileName Nome do ficheiro binrio onde o grafo ser guardado.
- * @return true se o grafo foi salvo com sucesso, false caso contrrio.
+ * O cabealho do dirio guarda a soma do snapshot a que pertence. Um dirio de outro snapshot
+ * (compactao interrompida entre a substituio do snapshot e a do dirio) no  reposto, pois
+ * as suas alteraes j esto no snapshot;  usado em vez dele o dirio novo que ficou no
+ * ficheiro temporrio, se pertencer ao snapshot, ou um dirio vazio.
  *
+ * @param ficheiroSnapshot Nome do ficheiro do snapshot.
+ * @param ficheiroDiario Nome do ficheiro do dirio.
+ * @return Um apontador para o grafo, ou NULL se os ficheiros forem invlidos.
  */
-bool GuardaGrafoBinario(Grafo* grafo, char fileName[]) {
-	if (grafo == NULL || fileName == NULL) {
-		return false;
+Grafo* AbreGrafoComDiario(char ficheiroSnapshot[], char ficheiroDiario[]) {
+	if (ficheiroSnapshot == NULL || ficheiroDiario == NULL) return NULL;
+
+	// Snapshot: se no existir, comea com um grafo vazio
+	unsigned long long somaSnapshot;
+	if (!SomaSnapshot(ficheiroSnapshot, &somaSnapshot)) return NULL;
+	Grafo* g = NULL;
+	FILE* teste = fopen(ficheiroSnapshot, "rb");
+	if (teste != NULL) {
+		fclose(teste);
+		g = CarregaGrafoBinario(ficheiroSnapshot);
 	}
+	else {
+		g = CriaGrafo();
+	}
+	if (g == NULL) return NULL;
 
-	FILE* fp = fopen(fileName, "wb");
-	if (fp == NULL) {
-		return false;
+	DiarioGrafo* diario = (DiarioGrafo*)calloc(1, sizeof(DiarioGrafo));
+	if (diario == NULL) {
+		DestroiGrafo(g);
+		return NULL;
+	}
+	diario->nomeSnapshot = (char*)malloc(strlen(ficheiroSnapshot) + 1);
+	diario->nomeDiario = (char*)malloc(strlen(ficheiroDiario) + 1);
+	if (diario->nomeSnapshot == NULL || diario->nomeDiario == NULL) {
+		g->diario = diario;
+		DestroiGrafo(g);
+		return NULL;
 	}
+	strcpy(diario->nomeSnapshot, ficheiroSnapshot);
+	strcpy(diario->nomeDiario, ficheiroDiario);
 
-	Vertices* verticeAtual = grafo->inicioGrafo;
-	while (verticeAtual != NULL) {
-		// Escreve o vrtice atual no ficheiro binrio
-		if (fwrite(&verticeAtual->id, sizeof(int), 1, fp) != 1) {
-			fclose(fp);
-			return false;
+	// Dirio: confirma que pertence ao snapshot
+	bool ok = true;
+	bool confere = false;
+	int cabecalho = 0;
+	diario->fp = fopen(ficheiroDiario, "r+b");
+	if (diario->fp != NULL) {
+		cabecalho = LeCabecalhoDiario(diario->fp, somaSnapshot, &confere);
+	}
+	if (cabecalho > 0 && !confere) {
+		fclose(diario->fp);
+		diario->fp = NULL;
+		cabecalho = 0;
+		char* tmpDiario = NomeTemporario(ficheiroDiario);
+		FILE* fpTmp = (tmpDiario != NULL) ? fopen(tmpDiario, "rb") : NULL;
+		if (fpTmp != NULL) {
+			bool adota = (LeCabecalhoDiario(fpTmp, somaSnapshot, &confere) > 0 && confere);
+			fclose(fpTmp);
+			if (adota && SubstituiFicheiro(tmpDiario, ficheiroDiario)) {
+				diario->fp = fopen(ficheiroDiario, "r+b");
+				if (diario->fp != NULL) cabecalho = LeCabecalhoDiario(diario->fp, somaSnapshot, &confere);
+			}
 		}
+		free(tmpDiario);
+	}
 
-		// Escreve o nmero de adjacncias do vrtice atual
-		int numAdjacencias = 0;
-		Adjacencias* adjacenciaAtual = verticeAtual->proxAdj;
-		while (adjacenciaAtual != NULL) {
-			numAdjacencias++;
-			adjacenciaAtual = adjacenciaAtual->next;
-		}
-		if (fwrite(&numAdjacencias, sizeof(int), 1, fp) != 1) {
-			fclose(fp);
-			return false;
+	// Repe os registos e posiciona a escrita a seguir ao ltimo registo completo
+	if (cabecalho > 0) {
+		long long lidos = RepoeDiario(g, diario->fp);
+		if (lidos >= 0) {
+#ifdef _WIN32
+			ok = (_fseeki64(diario->fp, (long long)cabecalho + lidos, SEEK_SET) == 0);
+#else
+			ok = (fseeko(diario->fp, (off_t)((long long)cabecalho + lidos), SEEK_SET) == 0);
+#endif
 		}
-
-		// Escreve as adjacncias do vrtice atual no ficheiro binrio
-		adjacenciaAtual = verticeAtual->proxAdj;
-		while (adjacenciaAtual != NULL) {
-			int adjData[2] = { adjacenciaAtual->id, adjacenciaAtual->peso };
-			if (fwrite(adjData, sizeof(int), 2, fp) != 2) {
-				fclose(fp);
-				return false;
-			}
-			adjacenciaAtual = adjacenciaAtual->next;
+		else {
+			ok = false;
 		}
-
-		verticeAtual = verticeAtual->proxVertice;
+		diario->numRegistos = ok ? lidos / (long long)sizeof(RegistoDiario) : 0;
+	}
+	else if (cabecalho == 0) {
+		if (diario->fp != NULL) fclose(diario->fp);
+		diario->fp = fopen(ficheiroDiario, "w+b");
+		ok = (diario->fp != NULL && IniciaFicheiroDiario(diario->fp, somaSnapshot));
+	}
+	else {
+		ok = false;
 	}
 
-	fclose(fp);
-	return true;
+	// S agora o dirio fica ligado, para a reposio no voltar a registar as alteraes
+	g->diario = diario;
+	if (!ok) {
+		DestroiGrafo(g);
+		return NULL;
+	}
+	return g;
 }
 
 
-
 /**
- * @brief Carrega a representao do grafo de um ficheiro binrio.
+ * @brief Acrescenta um registo ao dirio do grafo.
  *
- * Esta funo l a estrutura do grafo de um ficheiro binrio, recriando os vrtices e as adjacncias,
- * e exibe essas informaes.
+ * Chamada pelas funes que alteram o grafo antes de aplicarem a alterao, que s  feita se
+ * o registo for escrito; no faz nada se o grafo no tiver dirio. O registo  entregue ao sistema operativo de imediato.
  *
- * @param fileName O nome do ficheiro binrio de onde o grafo ser carregado.
- * @return Retorna 0 se o grafo foi carregado com sucesso, caso contrrio retorna -1.
+ * @param g Um apontador para o grafo.
+ * @param tipo O tipo de alterao.
+ * @param origem O vrtice inserido ou eliminado, ou a origem da adjacncia.
+ * @param destino O destino da adjacncia.
+ * @param peso O peso da adjacncia inserida.
+ * @return true se o registo foi escrito (ou no h dirio), false em caso de erro.
  */
-int CarregaGrafoBinario(char fileName[]) {
-	FILE* fp = fopen(fileName, "rb");
-	if (fp == NULL) {
-		return -1;
-	}
-
-	while (1) {
-		int idVertice;
-		if (fread(&idVertice, sizeof(int), 1, fp) != 1) {
-			if (feof(fp)) break; 
-			fclose(fp);
-			return -1;
-		}
+bool RegistaDiario(Grafo* g, TipoRegistoDiario tipo, int origem, int destino, int peso) {
+	if (g == NULL || g->diario == NULL) return true;
+	if (g->diario->fp == NULL) return false;
 
-		int numAdjacencias;
-		if (fread(&numAdjacencias, sizeof(int), 1, fp) != 1) {
-			fclose(fp);
-			return -1;
-		}
-
-		for (int i = 0; i < numAdjacencias; i++) {
-			int adjData[2];
-			if (fread(adjData, sizeof(int), 2, fp) != 2) {
-				fclose(fp);
-				return -1;
-			}
-		}
+	RegistoDiario r = { (int)tipo, origem, destino, peso };
+	if (fwrite(&r, sizeof(r), 1, g->diario->fp) != 1 || fflush(g->diario->fp) != 0) {
+		return false;
 	}
-
-	fclose(fp);
-	return 0;
+	g->diario->numRegistos++;
+	return true;
 }
 
+
 /**
- * @brief Realiza uma procura em profundidade recursiva (DFS) num grafo.
+ * @brief Junta as alteraes do dirio num novo snapshot e esvazia o dirio.
  *
- * Esta funo percorre recursivamente o grafo a partir de um vrtice de origem,
- * procurando todos os caminhos at um vrtice de destino. Durante a procura,
- * os vrtices visitados so marcados, e os caminhos encontrados so armazenados
- * e somados.
+ * O novo snapshot e o novo dirio so escritos em ficheiros temporrios e s depois
+ * substituem os anteriores, cada um numa s operao. O novo dirio guarda a soma do novo
+ * snapshot: se houver uma falha entre as duas substituies, AbreGrafoComDiario reconhece o
+ * dirio antigo como sendo de outro snapshot e no repete as suas alteraes. Nesse caso o
+ * dirio fica fechado, pois j no pertence ao snapshot, e as alteraes seguintes so
+ * recusadas at uma nova compactao, que volta a gerar os dois ficheiros.
  *
- * @param g Apontador para a estrutura do grafo.
- * @param origem O vrtice de origem para a procura.
- * @param destino O vrtice de destino para a procura.
- * @param visitado Array de booleanos que indica se um vrtice foi visitado.
- * @param caminho Array para armazenar o caminho atual.
- * @param indice ndice do prximo elemento no caminho.
- * @param somaCaminhos Apontador para a varivel que acumula a soma dos caminhos.
- * @return Apontador para a estrutura do grafo.
+ * @param g Um apontador para o grafo com dirio.
+ * @return true se a compactao foi feita, false caso contrrio (o dirio mantm-se vlido,
+ * ou fica fechado se o snapshot j tiver sido substitudo).
  */
-Grafo* ProcuraProfundidadeRec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos) {
-	visitado[origem] = true;
-	caminho[indice] = origem; // Adiciona o vrtice atual ao caminho
-	indice++;
+bool CompactaDiario(Grafo* g) {
+	if (g == NULL || g->diario == NULL) return false;
+	DiarioGrafo* diario = g->diario;
 
-	if (origem == destino) {
-		// Se o vrtice atual  o destino, imprime o caminho
-		for (int i = 0; i < indice; i++) {
-			printf("%d ", caminho[i]);
-		}
-		printf("\n");
+	char* tmpSnapshot = NomeTemporario(diario->nomeSnapshot);
+	char* tmpDiario = NomeTemporario(diario->nomeDiario);
+	if (tmpSnapshot == NULL || tmpDiario == NULL) {
+		free(tmpSnapshot);
+		free(tmpDiario);
+		return false;
+	}
 
-		// Calcula a soma dos valores dos vrtices no caminho
-		int soma = 0;
-		for (int i = 0; i < indice; i++) {
-			soma += caminho[i];
+	// Prepara o novo snapshot e o novo dirio em ficheiros temporrios
+	unsigned long long somaSnapshot = 0;
+	bool ok = GuardaGrafoBinario(g, tmpSnapshot) && SomaSnapshot(tmpSnapshot, &somaSnapshot);
+	FILE* novo = ok ? fopen(tmpDiario, "w+b") : NULL;
+	ok = (novo != NULL && IniciaFicheiroDiario(novo, somaSnapshot));
+	if (novo != NULL && fclose(novo) != 0) ok = false;
+
+	// Substitui os dois ficheiros; o dirio pode j estar fechado por uma compactao anterior
+	if (ok) {
+		if (diario->fp != NULL) fclose(diario->fp);
+		diario->fp = NULL;
+		if (!SubstituiFicheiro(tmpSnapshot, diario->nomeSnapshot)) {
+			// Nada foi substitudo: o dirio antigo continua a pertencer ao snapshot
+			ok = false;
+			remove(tmpSnapshot);
+			remove(tmpDiario);
 		}
-		*somaCaminhos += soma;
+		else if (!SubstituiFicheiro(tmpDiario, diario->nomeDiario)) {
+			// O dirio antigo  de outro snapshot: no pode receber mais registos
+			free(tmpSnapshot);
+			free(tmpDiario);
+			return false;
+		}
+		diario->fp = fopen(diario->nomeDiario, "r+b");
+		if (diario->fp != NULL) fseek(diario->fp, 0, SEEK_END);
+		ok = ok && (diario->fp != NULL);
+		if (ok) diario->numRegistos = 0;
 	}
 	else {
-		// Se o vrtice atual no  o destino, procura as adjacncias
-		Vertices* verticeAtual = OndeEstaVerticeGrafo(g, origem);
-		Adjacencias* adj = verticeAtual->proxAdj;
-		while (adj != NULL) {
-			if (!visitado[adj->id]) {
-				ProcuraProfundidadeRec(g, adj->id, destino, visitado, caminho, indice, somaCaminhos);
-			}
-			adj = adj->next;
-		}
+		remove(tmpSnapshot);
+		remove(tmpDiario);
 	}
 
-	indice--;                 // Decrementa o ndice do caminho para backtracking
-	visitado[origem] = false; // Marca o vrtice atual como no visitado para permitir outros caminhos
+	free(tmpSnapshot);
+	free(tmpDiario);
+	return ok;
+}
 
-	return g;
+
+/**
+ * @brief Fecha o dirio do grafo, sem compactar; as alteraes seguintes deixam de ser registadas.
+ *
+ * @param g Um apontador para o grafo (pode no ter dirio).
+ */
+void FechaDiario(Grafo* g) {
+	if (g == NULL || g->diario == NULL) return;
+
+	if (g->diario->fp != NULL) fclose(g->diario->fp);
+	free(g->diario->nomeSnapshot);
+	free(g->diario->nomeDiario);
+	free(g->diario);
+	g->diario = NULL;
 }
 
+#pragma endregion
+
+#pragma region Saida
 
 /**
- * @brief Realiza uma procura em profundidade (DFS) em um grafo e calcula a soma dos caminhos.
+ * @brief Abre uma sada de caminhos com buffer, em texto ou binrio.
  *
- * Esta funo inicia a procura em profundidade a partir de um vrtice de origem,
- * procurando todos os caminhos possveis at o vrtice de destino. Durante a procura,
- * os vrtices visitados so marcados, e os caminhos encontrados so somados.
+ * Os caminhos so formatados num buffer reutilizado e s so escritos no ficheiro quando
+ * este enche, pelo que cada descarga corresponde a uma nica escrita. O formato de texto 
+ * igual ao de ProcuraProfundidade (ids separados por espao, um caminho por linha); o binrio
+ * guarda cada caminho como o nmero de vrtices seguido dos ids, todos em int de 32 bits.
  *
- * @param g Apontador para a estrutura do grafo.
- * @param origem O vrtice de origem para a procura.
- * @param destino O vrtice de destino para a procura.
- * @param numVertices O nmero de vrtices no grafo.
- * @param soma Apontador para a varivel que ir armazenar a soma dos valores dos vrtices nos caminhos encontrados.
- * @return Apontador para a estrutura do grafo.
+ * @param fileName Nome do ficheiro de sada.
+ * @param binario true para o formato binrio, false para texto.
+ * @param capacidade Tamanho do buffer em bytes (0 para TAMANHOSAIDA).
+ * @return Um apontador para a sada, ou NULL se o ficheiro no abrir ou a alocao falhar.
  */
-Grafo* ProcuraProfundidade(Grafo* g, int origem, int destino, int numVertices, int* soma) {
-	bool* visitado = (bool*)malloc(numVertices * sizeof(bool)); 
-	int* caminho = (int*)malloc(numVertices * sizeof(int));     
-	int somaCaminhos = 0;                                       
+SaidaCaminhos* AbreSaidaCaminhos(char fileName[], bool binario, size_t capacidade) {
+	if (fileName == NULL) return NULL;
+	if (capacidade == 0) capacidade = TAMANHOSAIDA;
 
-	for (int i = 0; i < numVertices; i++) {
-		visitado[i] = false; // Inicializa todos os vrtices como no visitados
+	SaidaCaminhos* saida = (SaidaCaminhos*)malloc(sizeof(SaidaCaminhos));
+	if (saida == NULL) return NULL;
+	saida->buffer = (char*)malloc(capacidade);
+	saida->fp = fopen(fileName, binario ? "wb" : "w");
+	if (saida->buffer == NULL || saida->fp == NULL) {
+		if (saida->fp != NULL) fclose(saida->fp);
+		free(saida->buffer);
+		free(saida);
+		return NULL;
 	}
+	setvbuf(saida->fp, NULL, _IONBF, 0);
 
-	ProcuraProfundidadeRec(g, origem, destino, visitado, caminho, 0, &somaCaminhos);
-
-	*soma = somaCaminhos;
-	return g;
+	saida->capacidade = capacidade;
+	saida->usados = 0;
+	saida->binario = binario;
+	saida->bytesEscritos = 0;
+	saida->numCaminhos = 0;
+	timespec_get(&saida->inicio, TIME_UTC);
+	return saida;
 }
 
 
-
 /**
- * @brief Realiza uma procura em profundidade (DFS) em um grafo para encontrar o caminho com a maior soma de pesos entre dois vrtices.
+ * @brief Escreve um inteiro em decimal num buffer, sem recorrer ao printf.
  *
- * Esta funo percorre recursivamente o grafo a partir de um vrtice de origem, procurando o vrtice de destino. Durante o percurso,
- * calcula a soma dos pesos das arestas no caminho e compara com a maior soma j encontrada at o momento.
+ * @return O nmero de caracteres escritos (no mximo 11).
+ */
+static int FormataInteiro(char* destino, int valor) {
+	char digitos[12];
+	int n = 0;
+	unsigned int u = (valor < 0) ? 0u - (unsigned int)valor : (unsigned int)valor;
+	do {
+		digitos[n++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u != 0);
+
+	int k = 0;
+	if (valor < 0) destino[k++] = '-';
+	while (n > 0) {
+		destino[k++] = digitos[--n];
+	}
+	return k;
+}
+
+
+/**
+ * @brief Acrescenta um caminho  sada, descarregando o buffer se no houver espao.
  *
- * @param g Apontador para a estrutura do grafo.
- * @param origem ID do vrtice de origem.
- * @param destino ID do vrtice de destino.
- * @param visitado Array de booleanos indicando se um vrtice foi visitado durante o percurso.
- * @param caminho Array para armazenar o caminho atual.
- * @param indice ndice atual no caminho.
- * @param somaCaminhos Apontador para a varivel que armazena a soma dos pesos dos caminhos encontrados (no utilizado nesta funo).
- * @param somaMaxima Apontador para a varivel que armazena a maior soma de pesos encontrada.
- * @param caminhoMaximo Array para armazenar o caminho correspondente  maior soma encontrada.
- * @param numVertices Nmero total de vrtices no grafo.
- * @return Apontador para a estrutura do grafo.
+ * @param saida Apontador para a sada.
+ * @param caminho Os vrtices do caminho.
+ * @param tamanho O nmero de vrtices do caminho.
+ * @return true se o caminho foi acrescentado, false em caso de erro de escrita ou alocao.
  */
-Grafo* DFSrec(Grafo* g, int origem, int destino, bool* visitado, int* caminho, int indice, int* somaCaminhos, int* somaMaxima, int* caminhoMaximo, int numVertices) {
-	visitado[origem] = true;
-	caminho[indice] = origem; // Armazena o ID do vrtice atual no caminho
-	indice++;
+bool EscreveCaminho(SaidaCaminhos* saida, const int* caminho, int tamanho) {
+	if (saida == NULL || caminho == NULL || tamanho < 0) return false;
 
-	if (origem == destino) {
-		// Calcula a soma dos pesos das arestas no caminho
-		int soma = 0;
-		for (int i = 0; i < indice - 1; i++) {
-			Vertices* verticeAtual = g->inicioGrafo;
-			// Localiza o vrtice atual na lista de vrtices do grafo
-			while (verticeAtual != NULL && verticeAtual->id != caminho[i]) {
-				verticeAtual = verticeAtual->proxVertice;
-			}
-			// Verifica se o vrtice atual foi encontrado
-			if (verticeAtual == NULL) {
-				return NULL;
-			}
-			Adjacencias* adj = verticeAtual->proxAdj;
-			// Percorre as adjacncias do vrtice atual
-			while (adj != NULL) {
-				if (adj->id == caminho[i + 1]) {
-					soma += adj->peso;
-					break;
-				}
-				adj = adj->next;
-			}
+	// Espao mximo que o caminho pode ocupar no formato escolhido
+	size_t necessario = saida->binario ? ((size_t)tamanho + 1) * sizeof(int) : (size_t)tamanho * 12 + 1;
+	if (saida->usados + necessario > saida->capacidade) {
+		if (!DescarregaSaidaCaminhos(saida)) return false;
+		if (necessario > saida->capacidade) {
+			char* maior = (char*)realloc(saida->buffer, necessario);
+			if (maior == NULL) return false;
+			saida->buffer = maior;
+			saida->capacidade = necessario;
 		}
+	}
 
-		// Verifica se a soma  maior que a soma mxima encontrada at agora
-		if (soma > *somaMaxima) {
-			*somaMaxima = soma;
-			// Atualiza o caminho mximo correspondente
-			for (int i = 0; i < indice; i++) {
-				caminhoMaximo[i] = caminho[i];
-			}
-			// Define -1 nos elementos restantes do caminho mximo
-			for (int i = indice; i < numVertices; i++) {
-				caminhoMaximo[i] = -1;
-			}
-		}
+	char* p = saida->buffer + saida->usados;
+	if (saida->binario) {
+		memcpy(p, &tamanho, sizeof(int));
+		memcpy(p + sizeof(int), caminho, (size_t)tamanho * sizeof(int));
+		p += necessario;
 	}
 	else {
-		// Se o vrtice atual no  o destino, procura as adjacncias
-		Vertices* verticeAtual = g->inicioGrafo;
-		// Localiza o vrtice atual na lista de vrtices do grafo
-		while (verticeAtual != NULL && verticeAtual->id != origem) {
-			verticeAtual = verticeAtual->proxVertice;
-		}
-		// Verifica se o vrtice atual foi encontrado
-		if (verticeAtual == NULL) {
-			return NULL;
-		}
-		Adjacencias* adj = verticeAtual->proxAdj;
-		// Percorre as adjacncias do vrtice atual
-		while (adj != NULL) {
-			if (!visitado[adj->id]) {
-				DFSrec(g, adj->id, destino, visitado, caminho, indice, somaCaminhos, somaMaxima, caminhoMaximo, numVertices);
-			}
-			adj = adj->next;
+		for (int i = 0; i < tamanho; i++) {
+			p += FormataInteiro(p, caminho[i]);
+			*p++ = ' ';
 		}
+		*p++ = '\n';
 	}
-
-	// Backtracking
-	indice--;
-	visitado[origem] = false;
-	return g;
+	saida->usados = (size_t)(p - saida->buffer);
+	saida->numCaminhos++;
+	return true;
 }
 
 
+/**
+ * @brief Escreve no ficheiro o contedo do buffer da sada, numa nica escrita.
+ *
+ * @param saida Apontador para a sada.
+ * @return true se a escrita foi bem-sucedida, false caso contrrio.
+ */
+bool DescarregaSaidaCaminhos(SaidaCaminhos* saida) {
+	if (saida == NULL) return false;
+	if (saida->usados == 0) return true;
+
+	if (fwrite(saida->buffer, 1, saida->usados, saida->fp) != saida->usados) {
+		return false;
+	}
+	saida->bytesEscritos += (long long)saida->usados;
+	saida->usados = 0;
+	return true;
+}
+
 
 /**
- * @brief Encontra o caminho que proporciona a maior soma possvel dos inteiros no grafo, seguindo a regra de conexo estabelecida.
+ * @brief Calcula o dbito da sada, em MB/s, desde que foi aberta.
  *
- * Esta funo realiza uma busca em profundidade (DFS) no grafo a partir de um vrtice de origem, procurando o vrtice de destino.
- * Durante o percurso, calcula a soma dos pesos das arestas no caminho e compara com a maior soma j encontrada at o momento.
- * Ao final, exibe a soma mxima e o caminho correspondente.
+ * Conta os bytes j escritos e os que esto no buffer  espera de descarga.
  *
- * @param g Apontador para a estrutura do grafo.
- * @param origem ID do vrtice de origem.
- * @param destino ID do vrtice de destino.
- * @param numVertices Nmero total de vrtices no grafo.
+ * @param saida Apontador para a sada.
+ * @return O dbito em megabytes (10^6 bytes) por segundo, ou 0 se no tiver passado tempo mensurvel.
  */
-void encontrarCaminhoMaiorSoma(Grafo* g, int origem, int destino, int numVertices) {
-	bool* visitado = (bool*)malloc(sizeof(bool) * numVertices);
+double DebitoSaidaCaminhos(SaidaCaminhos* saida) {
+	if (saida == NULL) return 0.0;
 
-	int* caminho = (int*)malloc(sizeof(int) * numVertices);
+	struct timespec agora;
+	timespec_get(&agora, TIME_UTC);
+	double segundos = (double)(agora.tv_sec - saida->inicio.tv_sec) + (agora.tv_nsec - saida->inicio.tv_nsec) / 1e9;
+	if (segundos <= 0.0) return 0.0;
 
-	// Inicializa todos os vrtices como no visitados
-	for (int i = 0; i < numVertices; i++) {
-		visitado[i] = false;
-	}
+	double bytes = (double)saida->bytesEscritos + (double)saida->usados;
+	return bytes / 1e6 / segundos;
+}
 
-	int somaCaminhos = 0;
-	int somaMaxima = 0;
-	int* caminhoMaximo = (int*)malloc(sizeof(int) * numVertices);
 
-	DFSrec(g, origem, destino, visitado, caminho, 0, &somaCaminhos, &somaMaxima, caminhoMaximo, numVertices);
+/**
+ * @brief Descarrega o buffer, fecha o ficheiro e liberta a sada.
+ *
+ * @param saida Apontador para a sada (pode ser NULL).
+ * @return true se todos os caminhos foram escritos, false caso contrrio.
+ */
+bool FechaSaidaCaminhos(SaidaCaminhos* saida) {
+	if (saida == NULL) return false;
 
-	//Mostra soma mxima e o caminho correspondente
-	printf("Soma mxima: %d\n", somaMaxima);
-	printf("Caminho correspondente: ");
-	for (int i = 0; i < numVertices; i++) {
-		if (caminhoMaximo[i] != -1) {
-			printf("%d ", caminhoMaximo[i]);
-		}
-	}
-	printf("\n");
+	bool ok = DescarregaSaidaCaminhos(saida);
+	if (fclose(saida->fp) != 0) ok = false;
+	free(saida->buffer);
+	free(saida);
+	return ok;
 }
 
 
+/**
+ * @brief Visitante que escreve cada caminho numa sada com buffer.
+ *
+ * Pode ser passado a PercorreCaminhos ou PercorreCaminhosCSR; a procura termina se a escrita falhar.
+ *
+ * @param caminho Os vrtices do caminho.
+ * @param tamanho O nmero de vrtices do caminho.
+ * @param peso A soma dos pesos das arestas do caminho (no utilizado).
+ * @param contexto Apontador para a SaidaCaminhos.
+ * @return true para continuar a procura, false se a escrita falhar.
+ */
+bool VisitanteSaidaCaminhos(const int* caminho, int tamanho, int peso, void* contexto) {
+	(void)peso;
+	return EscreveCaminho((SaidaCaminhos*)contexto, caminho, tamanho);
+}
+
+#pragma endregion
@@ -95,20 +95,23 @@ int main() {
 		printf("Erro ao carregar o grafo.\n");
 	}
 
-	GuardaGrafoBinario(meuGrafo, "guarda.bin");
+	if (!GuardaGrafoBinario(meuGrafo, "guarda.bin")) {
+		printf("Erro ao guardar o grafo.\n");
+	}
 	
-	int resultado = CarregaGrafoBinario("guarda.bin");
+	Grafo* grafoCarregado = CarregaGrafoBinario("guarda.bin");
 
-	if (resultado == 0) {
+	if (grafoCarregado != NULL) {
 		printf("Grafo carregado do ficheiro binrio com sucesso.\n");
 	}
 	else {
 		printf("Erro ao carregar o grafo.\n");
 	}
+	DestroiGrafo(grafoCarregado);
 	
 
 	printf("\nRepresentao do Grafo:\n");
-	MostrarGrafo(meuGrafo->inicioGrafo);
+	ImprimeGrafo(meuGrafo);
 
 
 
@@ -123,7 +126,7 @@ int main() {
 
 	encontrarCaminhoMaiorSoma(meuGrafo, origem, destino, numLinhas);
 
-	free(meuGrafo);
+	DestroiGrafo(meuGrafo);
 #pragma endregion
 
 }
\ No newline at end of file